@@ -0,0 +1,123 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Command line tool to query the binary search index (search.dxi)
+ *  that doxygen writes next to the search.idx file of the server side search.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "searchindexreader.h"
+#include "version.h"
+
+static void usage(const char *name, int exitVal = 1)
+{
+  std::cerr << "Usage: " << name << " [-n max_results] [-p] [-t] search.dxi query words..." << std::endl;
+  std::cerr << "  -n  show at most max_results results (default 20, 0 for all)" << std::endl;
+  std::cerr << "  -p  list the terms starting with the query instead of searching" << std::endl;
+  std::cerr << "  -t  show the time needed to answer the query" << std::endl;
+  exit(exitVal);
+}
+
+int main(int argc,char **argv)
+{
+  size_t maxResults = 20;
+  bool   listTerms  = false;
+  bool   showTime   = false;
+  int i=1;
+  for (;i<argc && argv[i][0]=='-';i++)
+  {
+    if (std::strcmp(argv[i],"-n")==0 && i+1<argc)
+    {
+      maxResults = static_cast<size_t>(std::strtoul(argv[++i],0,10));
+    }
+    else if (std::strcmp(argv[i],"-p")==0)
+    {
+      listTerms = true;
+    }
+    else if (std::strcmp(argv[i],"-t")==0)
+    {
+      showTime = true;
+    }
+    else if (std::strcmp(argv[i],"-v")==0 || std::strcmp(argv[i],"--version")==0)
+    {
+      std::cout << argv[0] << " version: " << getFullVersion() << std::endl;
+      exit(0);
+    }
+    else if (std::strcmp(argv[i],"-h")==0 || std::strcmp(argv[i],"--help")==0)
+    {
+      usage(argv[0],0);
+    }
+    else
+    {
+      usage(argv[0]);
+    }
+  }
+  if (i+1>=argc)
+  {
+    usage(argv[0]);
+  }
+
+  SearchIndexReader reader;
+  if (!reader.open(argv[i]))
+  {
+    std::cerr << argv[i] << ": " << reader.errorString() << std::endl;
+    exit(1);
+  }
+  std::string query;
+  for (i++;i<argc;i++)
+  {
+    if (!query.empty()) query+=' ';
+    query+=argv[i];
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+  if (listTerms)
+  {
+    auto terms = reader.expand(query,maxResults);
+    auto endTime = std::chrono::steady_clock::now();
+    for (const auto &term : terms)
+    {
+      std::cout << term << std::endl;
+    }
+    if (showTime)
+    {
+      std::cerr << terms.size() << " terms in "
+                << std::chrono::duration_cast<std::chrono::microseconds>(endTime-startTime).count()
+                << " us" << std::endl;
+    }
+  }
+  else
+  {
+    auto results = reader.search(query,maxResults);
+    auto endTime = std::chrono::steady_clock::now();
+    for (const auto &r : results)
+    {
+      std::cout << r.score << "\t" << reader.docName(r.doc) << "\t" << reader.docUrl(r.doc) << std::endl;
+    }
+    if (showTime)
+    {
+      std::cerr << results.size() << " results in "
+                << std::chrono::duration_cast<std::chrono::microseconds>(endTime-startTime).count()
+                << " us" << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,454 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define SEARCHINDEX_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "searchindexreader.h"
+
+static const char     indexMagic[]     = "DXSI";
+static const uint32_t indexVersion     = 1;
+static const size_t   indexHeaderSize  = 72;
+
+static uint32_t getU32(const uint8_t *p)
+{
+  return  static_cast<uint32_t>(p[0])      | (static_cast<uint32_t>(p[1])<<8) |
+         (static_cast<uint32_t>(p[2])<<16) | (static_cast<uint32_t>(p[3])<<24);
+}
+
+static uint64_t getU64(const uint8_t *p)
+{
+  return static_cast<uint64_t>(getU32(p)) | (static_cast<uint64_t>(getU32(p+4))<<32);
+}
+
+/** Reads a varint at \a p, not reading beyond \a end. Returns false if the value is truncated. */
+static bool getVarint(const uint8_t *&p,const uint8_t *end,uint64_t &value)
+{
+  value = 0;
+  for (int shift=0; p<end && shift<64; shift+=7)
+  {
+    uint8_t c = *p++;
+    value |= static_cast<uint64_t>(c&0x7f)<<shift;
+    if ((c&0x80)==0) return true;
+  }
+  return false;
+}
+
+static bool startsWith(const std::string &s,const std::string &prefix)
+{
+  return s.size()>=prefix.size() && s.compare(0,prefix.size(),prefix)==0;
+}
+
+//------------------------------------------------------------------------
+
+struct SearchIndexReader::Private
+{
+  // the mapped (or loaded) file
+  const uint8_t *data = 0;
+  size_t size = 0;
+#ifdef SEARCHINDEX_NO_MMAP
+  std::vector<uint8_t> buffer;
+#endif
+  std::string errorString;
+
+  // header fields
+  uint32_t numTerms = 0;
+  uint32_t numDocs = 0;
+  uint32_t termsPerBlock = 0;
+  uint32_t numBlocks = 0;
+  uint64_t blockIndexOffset = 0;
+  uint64_t termsOffset = 0;
+  uint64_t postingsOffset = 0;
+  uint64_t docIndexOffset = 0;
+  uint64_t docsOffset = 0;
+
+  /** A decoded entry of the term dictionary. */
+  struct Term
+  {
+    std::string word;
+    uint64_t postings;
+    uint64_t numPostings;
+  };
+
+  /** Iterates over the terms, starting at the first term of a block. */
+  class TermCursor
+  {
+    public:
+      TermCursor(const Private &p,uint32_t block) : m_p(p), m_block(block), m_index(block*p.termsPerBlock)
+      {
+        seekBlock();
+      }
+      bool atEnd() const { return m_index>=m_p.numTerms || !m_valid; }
+      const Term &term() const { return m_term; }
+      void next()
+      {
+        m_index++;
+        if (m_index%m_p.termsPerBlock==0) // continue with the next block
+        {
+          m_block++;
+          seekBlock();
+        }
+        else
+        {
+          decode();
+        }
+      }
+    private:
+      void seekBlock()
+      {
+        if (m_block>=m_p.numBlocks) { m_valid=false; return; }
+        uint32_t offset = getU32(m_p.data+m_p.blockIndexOffset+4*m_block);
+        m_pos = m_p.data+m_p.termsOffset+offset;
+        m_term.word.clear();
+        decode();
+      }
+      void decode()
+      {
+        const uint8_t *end = m_p.data+m_p.postingsOffset;
+        uint64_t shared=0, suffix=0;
+        m_valid = m_index<m_p.numTerms &&
+                  getVarint(m_pos,end,shared) &&
+                  getVarint(m_pos,end,suffix) &&
+                  shared<=m_term.word.size() &&
+                  suffix<=static_cast<uint64_t>(end-m_pos);
+        if (!m_valid) return;
+        m_term.word.resize(shared);
+        m_term.word.append(reinterpret_cast<const char*>(m_pos),suffix);
+        m_pos+=suffix;
+        m_valid = getVarint(m_pos,end,m_term.postings) &&
+                  getVarint(m_pos,end,m_term.numPostings);
+      }
+      const Private &m_p;
+      uint32_t m_block;
+      uint32_t m_index;
+      const uint8_t *m_pos = 0;
+      bool m_valid = true;
+      Term m_term;
+  };
+
+  /** Returns the first term of \a block. */
+  std::string firstTerm(uint32_t block) const
+  {
+    const uint8_t *pos = data+termsOffset+getU32(data+blockIndexOffset+4*block);
+    const uint8_t *end = data+postingsOffset;
+    uint64_t shared=0, suffix=0;
+    if (!getVarint(pos,end,shared) || !getVarint(pos,end,suffix) ||
+        suffix>static_cast<uint64_t>(end-pos))
+    {
+      return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(pos),suffix);
+  }
+
+  /** Returns the block that contains \a word if it is in the index, that is
+   *  the last block whose first term is not larger than \a word.
+   */
+  uint32_t findBlock(const std::string &word) const
+  {
+    uint32_t lo=0, hi=numBlocks;
+    while (hi-lo>1)
+    {
+      uint32_t mid = lo+(hi-lo)/2;
+      if (firstTerm(mid)<=word) lo=mid; else hi=mid;
+    }
+    return lo;
+  }
+
+  std::vector<Posting> postings(const Term &term) const
+  {
+    std::vector<Posting> result;
+    const uint8_t *end = data+docIndexOffset;
+    if (term.postings>=docIndexOffset-postingsOffset) return result;
+    const uint8_t *pos = data+postingsOffset+term.postings;
+    result.reserve(std::min<uint64_t>(term.numPostings,numDocs));
+    uint64_t doc = 0;
+    for (uint64_t i=0; i<term.numPostings; i++)
+    {
+      uint64_t delta=0, freq=0;
+      if (!getVarint(pos,end,delta) || !getVarint(pos,end,freq)) break;
+      doc+=delta;
+      if (doc>=numDocs) break;
+      result.push_back(Posting{ static_cast<uint32_t>(doc), static_cast<uint32_t>(freq) });
+    }
+    return result;
+  }
+
+  /** Returns the name (\a field is 0) or url (\a field is 1) of \a doc. */
+  std::string docField(uint32_t doc,int field) const
+  {
+    if (doc>=numDocs) return std::string();
+    const uint8_t *pos = data+docsOffset+getU32(data+docIndexOffset+4*doc);
+    const uint8_t *end = data+size;
+    for (int i=0;;i++)
+    {
+      uint64_t len=0;
+      if (pos>=end || !getVarint(pos,end,len) || len>static_cast<uint64_t>(end-pos)) return std::string();
+      if (i==field) return std::string(reinterpret_cast<const char*>(pos),len);
+      pos+=len;
+    }
+  }
+
+  bool readHeader()
+  {
+    if (size<indexHeaderSize || memcmp(data,indexMagic,4)!=0)
+    {
+      errorString = "not a doxygen search index";
+      return false;
+    }
+    uint32_t version = getU32(data+4);
+    if (version!=indexVersion)
+    {
+      errorString = "unsupported search index version "+std::to_string(version);
+      return false;
+    }
+    numTerms         = getU32(data+8);
+    numDocs          = getU32(data+12);
+    termsPerBlock    = getU32(data+16);
+    numBlocks        = getU32(data+20);
+    blockIndexOffset = getU64(data+24);
+    termsOffset      = getU64(data+32);
+    postingsOffset   = getU64(data+40);
+    docIndexOffset   = getU64(data+48);
+    docsOffset       = getU64(data+56);
+    uint64_t fileSize= getU64(data+64);
+    bool valid = fileSize==size && termsPerBlock>0 &&
+                 numBlocks==(static_cast<uint64_t>(numTerms)+termsPerBlock-1)/termsPerBlock &&
+                 indexHeaderSize<=blockIndexOffset &&
+                 blockIndexOffset+4*static_cast<uint64_t>(numBlocks)<=termsOffset &&
+                 termsOffset<=postingsOffset &&
+                 postingsOffset<=docIndexOffset &&
+                 docIndexOffset+4*static_cast<uint64_t>(numDocs)<=docsOffset &&
+                 docsOffset<=fileSize;
+    if (!valid)
+    {
+      errorString = "corrupt search index";
+      return false;
+    }
+    return true;
+  }
+
+  void unmap()
+  {
+#ifdef SEARCHINDEX_NO_MMAP
+    buffer.clear();
+#else
+    if (data) munmap(const_cast<uint8_t*>(data),size);
+#endif
+    data = 0;
+    size = 0;
+    numTerms = numDocs = numBlocks = 0;
+  }
+};
+
+SearchIndexReader::SearchIndexReader() : p(std::make_unique<Private>())
+{
+}
+
+SearchIndexReader::~SearchIndexReader()
+{
+  close();
+}
+
+bool SearchIndexReader::open(const std::string &fileName)
+{
+  close();
+#ifdef SEARCHINDEX_NO_MMAP
+  std::ifstream f(fileName,std::ifstream::in | std::ifstream::binary);
+  if (!f.is_open())
+  {
+    p->errorString = "cannot open "+fileName;
+    return false;
+  }
+  p->buffer.assign(std::istreambuf_iterator<char>(f),std::istreambuf_iterator<char>());
+  p->data = p->buffer.data();
+  p->size = p->buffer.size();
+#else
+  int fd = ::open(fileName.c_str(),O_RDONLY);
+  if (fd==-1)
+  {
+    p->errorString = "cannot open "+fileName+": "+strerror(errno);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd,&st)==-1 || st.st_size==0)
+  {
+    p->errorString = "not a doxygen search index";
+    ::close(fd);
+    return false;
+  }
+  void *addr = mmap(0,static_cast<size_t>(st.st_size),PROT_READ,MAP_SHARED,fd,0);
+  ::close(fd);
+  if (addr==MAP_FAILED)
+  {
+    p->errorString = "cannot map "+fileName+": "+strerror(errno);
+    return false;
+  }
+  p->data = static_cast<const uint8_t*>(addr);
+  p->size = static_cast<size_t>(st.st_size);
+#endif
+  if (!p->readHeader())
+  {
+    p->unmap();
+    return false;
+  }
+  return true;
+}
+
+void SearchIndexReader::close()
+{
+  p->unmap();
+}
+
+const std::string &SearchIndexReader::errorString() const
+{
+  return p->errorString;
+}
+
+uint32_t SearchIndexReader::numTerms() const
+{
+  return p->numTerms;
+}
+
+uint32_t SearchIndexReader::numDocs() const
+{
+  return p->numDocs;
+}
+
+std::string SearchIndexReader::docName(uint32_t doc) const
+{
+  return p->docField(doc,0);
+}
+
+std::string SearchIndexReader::docUrl(uint32_t doc) const
+{
+  return p->docField(doc,1);
+}
+
+std::vector<SearchIndexReader::Posting> SearchIndexReader::lookup(const std::string &term) const
+{
+  if (p->numTerms==0) return std::vector<Posting>();
+  for (Private::TermCursor c(*p,p->findBlock(term)); !c.atEnd(); c.next())
+  {
+    if (c.term().word==term) return p->postings(c.term());
+    if (c.term().word>term) break;
+  }
+  return std::vector<Posting>();
+}
+
+std::vector<std::string> SearchIndexReader::expand(const std::string &prefix,size_t maxTerms) const
+{
+  std::vector<std::string> result;
+  if (p->numTerms==0) return result;
+  for (Private::TermCursor c(*p,p->findBlock(prefix)); !c.atEnd(); c.next())
+  {
+    const std::string &word = c.term().word;
+    if (startsWith(word,prefix))
+    {
+      result.push_back(word);
+      if (maxTerms!=0 && result.size()>=maxTerms) break;
+    }
+    else if (word>prefix)
+    {
+      break;
+    }
+  }
+  return result;
+}
+
+std::vector<SearchIndexReader::Result> SearchIndexReader::search(const std::string &query,size_t maxResults) const
+{
+  // split the query in lower case words, like doxygen does when indexing
+  std::vector<std::string> words;
+  std::string word;
+  for (char c : query+" ")
+  {
+    if (c==' ' || c=='\t' || c=='\n')
+    {
+      if (!word.empty()) words.push_back(word);
+      word.clear();
+    }
+    else
+    {
+      word+=static_cast<char>(c>='A' && c<='Z' ? c-'A'+'a' : c);
+    }
+  }
+  std::vector<Result> results;
+  if (words.empty() || p->numTerms==0) return results;
+
+  std::unordered_map<uint32_t,double> scores; // documents matching all words seen so far
+  bool first = true;
+  for (const auto &w : words)
+  {
+    std::unordered_map<uint32_t,double> wordScores;
+    for (Private::TermCursor c(*p,p->findBlock(w)); !c.atEnd(); c.next())
+    {
+      const Private::Term &term = c.term();
+      if (!startsWith(term.word,w))
+      {
+        if (term.word>w) break;
+        continue;
+      }
+      bool exact = term.word.size()==w.size();
+      for (const auto &posting : p->postings(term))
+      {
+        if (!first && scores.find(posting.doc)==scores.end()) continue;
+        double score = static_cast<double>(posting.freq>>1);
+        if (exact)          score*=2; // exact match
+        if (posting.freq&1) score*=4; // match in the name of the document
+        wordScores[posting.doc]+=score;
+      }
+    }
+    if (!first)
+    {
+      for (auto &kv : wordScores) kv.second+=scores[kv.first];
+    }
+    scores.swap(wordScores);
+    first = false;
+    if (scores.empty()) break;
+  }
+
+  results.reserve(scores.size());
+  for (const auto &kv : scores)
+  {
+    results.push_back(Result{ kv.first, kv.second });
+  }
+  auto byScore = [](const Result &r1,const Result &r2)
+  {
+    return r1.score>r2.score || (r1.score==r2.score && r1.doc<r2.doc);
+  };
+  if (maxResults!=0 && results.size()>maxResults)
+  {
+    std::partial_sort(results.begin(),results.begin()+static_cast<std::ptrdiff_t>(maxResults),results.end(),byScore);
+    results.resize(maxResults);
+  }
+  else
+  {
+    std::sort(results.begin(),results.end(),byScore);
+  }
+  return results;
+}
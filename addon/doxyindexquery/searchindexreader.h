@@ -0,0 +1,86 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef SEARCHINDEXREADER_H
+#define SEARCHINDEXREADER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** @brief Read access to the binary search index (search.dxi) written by doxygen.
+ *
+ *  The file is mapped into memory (or read in one go on platforms without
+ *  mmap) and queried in place: terms are found with a binary search over
+ *  the blocks of the sorted term dictionary followed by a scan of at most
+ *  one block, so a lookup does not depend on the size of the index.
+ *  See searchindex.cpp in the doxygen sources for the file format.
+ */
+class SearchIndexReader
+{
+  public:
+    /** A document containing a term. */
+    struct Posting
+    {
+      uint32_t doc;   //!< document id, use docName() and docUrl() to get its details
+      uint32_t freq;  //!< number of occurrences times 2, plus 1 for a high priority match
+    };
+
+    /** A document matching a query. */
+    struct Result
+    {
+      uint32_t doc;
+      double   score;
+    };
+
+    SearchIndexReader();
+   ~SearchIndexReader();
+    SearchIndexReader(const SearchIndexReader &) = delete;
+    SearchIndexReader &operator=(const SearchIndexReader &) = delete;
+
+    /** Opens the index file \a fileName. Returns false and sets errorString()
+     *  if the file cannot be read or is not a valid index.
+     */
+    bool open(const std::string &fileName);
+    void close();
+    const std::string &errorString() const;
+
+    uint32_t numTerms() const;
+    uint32_t numDocs() const;
+    std::string docName(uint32_t doc) const;
+    std::string docUrl(uint32_t doc) const;
+
+    /** Returns the documents containing the term \a term, sorted on document id. */
+    std::vector<Posting> lookup(const std::string &term) const;
+
+    /** Returns all terms starting with \a prefix, in sorted order.
+     *  At most \a maxTerms terms are returned, 0 means no limit.
+     */
+    std::vector<std::string> expand(const std::string &prefix,size_t maxTerms=0) const;
+
+    /** Returns the documents that match all words of \a query, sorted on
+     *  decreasing score. Each word matches the terms it is a prefix of;
+     *  exact and high priority matches are ranked higher.
+     *  At most \a maxResults results are returned, 0 means no limit.
+     */
+    std::vector<Result> search(const std::string &query,size_t maxResults=0) const;
+
+  private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -0,0 +1,77 @@
+# - Try to find the graphviz libraries used to render graphs in-process
+# Once done this will define
+#
+#  GRAPHVIZ_FOUND - system has the graphviz libraries
+#  GRAPHVIZ_INCLUDE_DIRS - the graphviz include directory
+#  GRAPHVIZ_LIBRARIES - Link these to use libgvc and libcgraph
+#  GRAPHVIZ_VERSION - version of graphviz that was found
+#
+
+if (GRAPHVIZ_LIBRARIES AND GRAPHVIZ_INCLUDE_DIRS)
+  # in cache already
+  set(GRAPHVIZ_FOUND TRUE)
+else (GRAPHVIZ_LIBRARIES AND GRAPHVIZ_INCLUDE_DIRS)
+  # use pkg-config to get the directories and then use these values
+  # in the FIND_PATH() and FIND_LIBRARY() calls
+  find_package(PkgConfig)
+  if (PKG_CONFIG_FOUND)
+    pkg_check_modules(_GRAPHVIZ libgvc)
+  endif (PKG_CONFIG_FOUND)
+
+  find_path(GRAPHVIZ_INCLUDE_DIR
+    NAMES
+      gvc.h
+    PATHS
+      ${_GRAPHVIZ_INCLUDEDIR}
+      ${_GRAPHVIZ_INCLUDE_DIRS}
+      /usr/include
+      /usr/local/include
+      /opt/local/include
+      /sw/include
+    PATH_SUFFIXES
+      graphviz
+  )
+
+  find_library(GRAPHVIZ_GVC_LIBRARY
+    NAMES
+      gvc
+    PATHS
+      ${_GRAPHVIZ_LIBDIR}
+      /usr/lib
+      /usr/local/lib
+      /opt/local/lib
+      /sw/lib
+  )
+
+  find_library(GRAPHVIZ_CGRAPH_LIBRARY
+    NAMES
+      cgraph
+    PATHS
+      ${_GRAPHVIZ_LIBDIR}
+      /usr/lib
+      /usr/local/lib
+      /opt/local/lib
+      /sw/lib
+  )
+
+  if (GRAPHVIZ_INCLUDE_DIR AND GRAPHVIZ_GVC_LIBRARY AND GRAPHVIZ_CGRAPH_LIBRARY)
+    set(GRAPHVIZ_FOUND TRUE)
+    set(GRAPHVIZ_INCLUDE_DIRS ${GRAPHVIZ_INCLUDE_DIR})
+    set(GRAPHVIZ_LIBRARIES ${GRAPHVIZ_GVC_LIBRARY} ${GRAPHVIZ_CGRAPH_LIBRARY})
+    set(GRAPHVIZ_VERSION ${_GRAPHVIZ_VERSION})
+  endif ()
+
+  if (GRAPHVIZ_FOUND)
+    if (NOT Graphviz_FIND_QUIETLY)
+      message(STATUS "Found graphviz: ${GRAPHVIZ_LIBRARIES} (found version \"${GRAPHVIZ_VERSION}\")")
+    endif (NOT Graphviz_FIND_QUIETLY)
+  else (GRAPHVIZ_FOUND)
+    if (Graphviz_FIND_REQUIRED)
+      message(FATAL_ERROR "Could not find the graphviz libraries libgvc and libcgraph")
+    endif (Graphviz_FIND_REQUIRED)
+  endif (GRAPHVIZ_FOUND)
+
+  # show the GRAPHVIZ_INCLUDE_DIRS and GRAPHVIZ_LIBRARIES variables only in the advanced view
+  mark_as_advanced(GRAPHVIZ_INCLUDE_DIRS GRAPHVIZ_LIBRARIES)
+
+endif (GRAPHVIZ_LIBRARIES AND GRAPHVIZ_INCLUDE_DIRS)
@@ -16,8 +16,12 @@
 #ifndef CACHE_H
 #define CACHE_H
 
+#include <algorithm>
 #include <list>
+#include <deque>
+#include <vector>
 #include <unordered_map>
+#include <functional>
 #include <mutex>
 #include <ctype.h>
 
@@ -159,4 +163,332 @@ class Cache
     uint64_t m_misses=0;
 };
 
+/*! Cache for value type V using keys of type K that can be
+ *  used from multiple threads at the same time.
+ *
+ *  The cache is split into a number of shards, each with its own lock and its own
+ *  least recently used list, so threads that access different keys rarely wait
+ *  for each other. The hash of a key is computed only once per operation and is
+ *  used both to select the shard and to look up the key within the shard.
+ *
+ *  Since values can be evicted by other threads at any moment, values are
+ *  copied in and out of the cache, rather than returned by pointer.
+ *
+ *  By default the capacity is fixed. After calling setAdaptive() each shard
+ *  adjusts its own capacity: it doubles when a significant part of the lookups
+ *  has to evict an entry, and it halves when hardly any lookup is a hit.
+ */
+template<typename K,typename V,typename Hash=std::hash<K> >
+class ConcurrentCache
+{
+  public:
+    //! creates a cache that can hold \a capacity elements divided over \a numShards shards
+    ConcurrentCache(size_t capacity,size_t numShards=64)
+      : m_shards(std::max<size_t>(numShards,1))
+    {
+      size_t shardCapacity = std::max<size_t>(capacity/m_shards.size(),1);
+      for (auto &shard : m_shards) shard.capacity = shardCapacity;
+    }
+
+    //! Lets the capacity of the cache adapt to the lookups, staying within
+    //! the range [\a minCapacity, \a maxCapacity].
+    void setAdaptive(size_t minCapacity,size_t maxCapacity)
+    {
+      size_t minShardCapacity = std::max<size_t>(minCapacity/m_shards.size(),1);
+      size_t maxShardCapacity = std::max<size_t>(maxCapacity/m_shards.size(),minShardCapacity);
+      for (auto &shard : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.minCapacity = minShardCapacity;
+        shard.maxCapacity = maxShardCapacity;
+        shard.resize(std::min(std::max(shard.capacity,minShardCapacity),maxShardCapacity));
+      }
+    }
+
+    //! Finds a value in the cache given the corresponding \a key.
+    //! If found the value is copied to \a value and \c true is returned.
+    //! @note The hit and miss counters are updated, see hits() and misses().
+    bool find(const K &key,V &value)
+    {
+      size_t hash = m_hash(key);
+      Shard &shard = shardFor(hash);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      uint32_t idx = shard.lookup(hash,key);
+      if (idx!=Shard::NIL)
+      {
+        shard.moveToFront(idx);
+        shard.hits++;
+        shard.windowHits++;
+        value = shard.nodes[idx].value;
+        shard.adapt();
+        return true;
+      }
+      shard.misses++;
+      shard.adapt();
+      return false;
+    }
+
+    //! Inserts \a value under \a key in the cache, replacing any existing value.
+    void insert(const K &key,V &&value)
+    {
+      size_t hash = m_hash(key);
+      Shard &shard = shardFor(hash);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.insert(hash,key,std::move(value));
+    }
+
+    //! Inserts \a value under \a key in the cache, replacing any existing value.
+    void insert(const K &key,const V &value)
+    {
+      insert(key,V(value));
+    }
+
+    //! Removes entry \a key from the cache.
+    void remove(const K &key)
+    {
+      size_t hash = m_hash(key);
+      Shard &shard = shardFor(hash);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      uint32_t idx = shard.lookup(hash,key);
+      if (idx!=Shard::NIL) shard.erase(idx);
+    }
+
+    //! Removes all entries for which \a pred(key,value) returns \c true.
+    template<class Pred>
+    void removeIf(Pred pred)
+    {
+      for (auto &shard : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        uint32_t idx = shard.head;
+        while (idx!=Shard::NIL)
+        {
+          uint32_t next = shard.nodes[idx].next;
+          if (pred(shard.nodes[idx].key,static_cast<const V&>(shard.nodes[idx].value)))
+          {
+            shard.erase(idx);
+          }
+          idx = next;
+        }
+      }
+    }
+
+    //! Returns the number of values stored in the cache.
+    size_t size() const
+    {
+      size_t result=0;
+      for (const auto &shard : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        result+=shard.map.size();
+      }
+      return result;
+    }
+
+    //! Returns the maximum number of values that can currently be stored in the cache.
+    size_t capacity() const
+    {
+      size_t result=0;
+      for (const auto &shard : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        result+=shard.capacity;
+      }
+      return result;
+    }
+
+    //! Returns how many of the find() calls did find a value in the cache.
+    uint64_t hits() const
+    {
+      uint64_t result=0;
+      for (const auto &shard : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        result+=shard.hits;
+      }
+      return result;
+    }
+
+    //! Returns how many of the find() calls did not found a value in the cache.
+    uint64_t misses() const
+    {
+      uint64_t result=0;
+      for (const auto &shard : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        result+=shard.misses;
+      }
+      return result;
+    }
+
+    //! Clears all values in the cache.
+    void clear()
+    {
+      for (auto &shard : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.clear();
+      }
+    }
+
+  private:
+    /** Reference to a key stored in a shard, together with its hash value. */
+    struct KeyRef
+    {
+      size_t hash;
+      const K *key;
+    };
+    struct KeyRefHash
+    {
+      size_t operator()(const KeyRef &k) const { return k.hash; }
+    };
+    struct KeyRefEqual
+    {
+      bool operator()(const KeyRef &k1,const KeyRef &k2) const
+      { return k1.hash==k2.hash && *k1.key==*k2.key; }
+    };
+
+    /** Part of the cache protected by a single lock. The nodes form an
+     *  intrusive doubly linked list ordered from most to least recently used.
+     */
+    struct Shard
+    {
+      static const uint32_t NIL = 0xFFFFFFFF;
+      struct Node
+      {
+        K key;
+        V value;
+        size_t hash = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+      };
+      mutable std::mutex mutex;
+      std::deque<Node> nodes;            // deque: stored keys do not move when growing
+      std::vector<uint32_t> freeNodes;
+      std::unordered_map<KeyRef,uint32_t,KeyRefHash,KeyRefEqual> map;
+      uint32_t head = NIL;
+      uint32_t tail = NIL;
+      size_t capacity = 1;
+      size_t minCapacity = 0;
+      size_t maxCapacity = 0;     // 0 means that the capacity is fixed
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      size_t windowLookups = 0;   // statistics since the last adapt step
+      size_t windowHits = 0;
+      size_t windowEvictions = 0;
+
+      uint32_t lookup(size_t hash,const K &key) const
+      {
+        auto it = map.find(KeyRef{hash,&key});
+        return it!=map.end() ? it->second : NIL;
+      }
+      void unlink(uint32_t idx)
+      {
+        Node &n = nodes[idx];
+        if (n.prev!=NIL) nodes[n.prev].next = n.next; else head = n.next;
+        if (n.next!=NIL) nodes[n.next].prev = n.prev; else tail = n.prev;
+        n.prev = n.next = NIL;
+      }
+      void linkFront(uint32_t idx)
+      {
+        Node &n = nodes[idx];
+        n.prev = NIL;
+        n.next = head;
+        if (head!=NIL) nodes[head].prev = idx;
+        head = idx;
+        if (tail==NIL) tail = idx;
+      }
+      void moveToFront(uint32_t idx)
+      {
+        if (idx!=head)
+        {
+          unlink(idx);
+          linkFront(idx);
+        }
+      }
+      void erase(uint32_t idx)
+      {
+        Node &n = nodes[idx];
+        map.erase(KeyRef{n.hash,&n.key});
+        unlink(idx);
+        n.key = K();
+        n.value = V();
+        freeNodes.push_back(idx);
+      }
+      void insert(size_t hash,const K &key,V &&value)
+      {
+        uint32_t idx = lookup(hash,key);
+        if (idx!=NIL) // replace existing value
+        {
+          nodes[idx].value = std::move(value);
+          moveToFront(idx);
+          return;
+        }
+        if (map.size()>=capacity && tail!=NIL) // full: evict least recently used
+        {
+          erase(tail);
+          windowEvictions++;
+        }
+        if (!freeNodes.empty())
+        {
+          idx = freeNodes.back();
+          freeNodes.pop_back();
+        }
+        else
+        {
+          idx = static_cast<uint32_t>(nodes.size());
+          nodes.emplace_back();
+        }
+        Node &n = nodes[idx];
+        n.key   = key;
+        n.value = std::move(value);
+        n.hash  = hash;
+        linkFront(idx);
+        map.emplace(KeyRef{hash,&n.key},idx);
+      }
+      void resize(size_t newCapacity)
+      {
+        capacity = newCapacity;
+        while (map.size()>capacity && tail!=NIL)
+        {
+          erase(tail);
+        }
+      }
+      void adapt()
+      {
+        if (maxCapacity==0) return;
+        // judge the shard over a number of lookups that is proportional to its size
+        if (++windowLookups<std::max<size_t>(capacity,1024)) return;
+        if (windowHits*100<windowLookups)
+        {
+          // less than 1% of the lookups is a hit: the memory is not worth it
+          if (capacity>minCapacity) resize(std::max(capacity/2,minCapacity));
+        }
+        else if (windowEvictions*20>windowLookups && capacity<maxCapacity)
+        {
+          // more than 5% of the lookups evict an entry: the working set does not fit
+          resize(std::min(capacity*2,maxCapacity));
+        }
+        windowLookups = windowHits = windowEvictions = 0;
+      }
+      void clear()
+      {
+        map.clear();
+        nodes.clear();
+        freeNodes.clear();
+        head = tail = NIL;
+      }
+    };
+
+    Shard &shardFor(size_t hash)
+    {
+      // use the high bits so the shard choice is independent of the
+      // bucket choice within the shard's hash table.
+      return m_shards[(hash>>(sizeof(size_t)*8-16)) % m_shards.size()];
+    }
+
+    std::vector<Shard> m_shards;
+    Hash m_hash;
+};
+
 #endif
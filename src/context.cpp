@@ -14,6 +14,7 @@
  */
 
 #include <assert.h>
+#include <mutex>
 #include <sstream>
 
 #include "context.h"
@@ -73,11 +74,43 @@ enum ContextOutputFormat
 
 struct ContextGlobals
 {
-  int                 dynSectionId;
   QCString            outputDir;
   ContextOutputFormat outputFormat;
 } g_globals;
 
+/** Identifier of the next collapsible section. It is numbered per created file,
+ *  so the ids in a file do not depend on the files rendered before it or on
+ *  the thread that renders it.
+ */
+static THREAD_LOCAL int t_dynSectionId = 0;
+
+/** Restarts the section numbering for each created file */
+class DynSectionNumbering : public TemplatePageIntf
+{
+  public:
+    int enterPage()
+    {
+      int outerId = t_dynSectionId;
+      t_dynSectionId = 0;
+      return outerId;
+    }
+    void leavePage(int outerId)
+    {
+      t_dynSectionId = outerId;
+    }
+};
+
+/** Attaches a cache of type \a C to definition \a d, unless it has one already.
+ *  Contexts for the same definition can be created by several threads at once.
+ */
+template<class C,class D>
+static void initCookie(const D *d)
+{
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!d->cookie()) d->setCookie(new C(d));
+}
+
 
 /** @brief Template List iterator support */
 class GenericConstIterator : public TemplateListIntf::ConstIterator
@@ -201,7 +234,11 @@ class PropertyMapper
       }
       else
       {
-        m_map.insert(std::make_pair(name,std::make_unique<PropertyFunc>(handle)));
+        auto func = std::make_unique<PropertyFunc>(handle);
+        TemplateKey key(name);
+        if (key.id()>=m_slots.size()) m_slots.resize(key.id()+1,0);
+        m_slots[key.id()] = func.get();
+        m_map.insert(std::make_pair(name,std::move(func)));
       }
     }
 
@@ -219,6 +256,18 @@ class PropertyMapper
       return it!=m_map.end() ? (*it->second)(obj) : TemplateVariant();
     }
 
+    /** Gets the value of a property using its key, without comparing names.
+     *  @param[in] obj  The object handling access to the property.
+     *  @param[in] key  The key of the property.
+     *  @returns A variant representing the properties value or an
+     *  invalid variant if it was not found.
+     */
+    TemplateVariant lookup(const T *obj,const TemplateKey &key) const
+    {
+      const PropertyFuncIntf *func = key.id()<m_slots.size() ? m_slots[key.id()] : 0;
+      return func ? (*func)(obj) : TemplateVariant();
+    }
+
     StringVector fields() const
     {
       StringVector result;
@@ -232,6 +281,7 @@ class PropertyMapper
 
   private:
     std::unordered_map<std::string,std::unique_ptr<PropertyFuncIntf>> m_map;
+    std::vector<const PropertyFuncIntf*> m_slots; // properties indexed by TemplateKey::id()
 };
 
 
@@ -246,6 +296,7 @@ class ConfigContext::Private
     virtual ~Private() { }
     TemplateVariant fetchList(const QCString &name,const StringVector &list)
     {
+      std::lock_guard<std::mutex> lock(m_mutex);
       auto it = m_cachedLists.find(name.str());
       if (it==m_cachedLists.end())
       {
@@ -264,6 +315,7 @@ class ConfigContext::Private
     }
   private:
     std::unordered_map<std::string,TemplateVariant> m_cachedLists;
+    std::mutex m_mutex;
 };
 //%% }
 
@@ -343,8 +395,8 @@ class DoxygenContext::Private
     }
     Private()
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         //%% string version
         s_inst.addProperty("version",         &Private::version);
@@ -354,13 +406,16 @@ class DoxygenContext::Private
         s_inst.addProperty("mathJaxCodeFile", &Private::mathJaxCodeFile);
         //%% string maxJaxMacros
         s_inst.addProperty("mathJaxMacros",   &Private::mathJaxMacros);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -396,6 +451,11 @@ TemplateVariant DoxygenContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant DoxygenContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector DoxygenContext::fields() const
 {
   return p->fields();
@@ -1009,8 +1069,8 @@ class TranslateContext::Private
     }
     Private()
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         //%% string generatedBy
         s_inst.addProperty("generatedBy",       &Private::generatedBy);
@@ -1211,8 +1271,7 @@ class TranslateContext::Private
         //%% string code
         s_inst.addProperty("code",               &Private::code);
 
-        init=TRUE;
-      }
+      });
 
       m_javaOpt    = Config_getBool(OPTIMIZE_OUTPUT_JAVA);
         m_fortranOpt = Config_getBool(OPTIMIZE_FOR_FORTRAN);
@@ -1224,6 +1283,10 @@ class TranslateContext::Private
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -1253,20 +1316,39 @@ TemplateVariant TranslateContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant TranslateContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector TranslateContext::fields() const
 {
   return p->fields();
 }
 
-static TemplateVariant parseDoc(const Definition *def,const QCString &file,int line,
-                                const QCString &relPath,const QCString &docStr,bool isBrief)
+/** @brief A parsed documentation block, that can be rendered for every output format.
+ *  The nodes of the tree refer to the parser, so it is kept alive as well.
+ */
+struct ParsedDoc
+{
+  std::unique_ptr<IDocParser> parser;
+  std::unique_ptr<DocRoot>    root;
+};
+
+static std::unique_ptr<ParsedDoc> parseDocTree(const Definition *def,const QCString &file,int line,
+                                               const QCString &docStr,bool isBrief)
+{
+  auto doc = std::make_unique<ParsedDoc>();
+  doc->parser = createDocParser();
+  doc->root.reset(validatingParseDoc(*doc->parser.get(),file,line,def,0,docStr,TRUE,FALSE,
+                                     QCString(),isBrief,FALSE,Config_getBool(MARKDOWN_SUPPORT)));
+  return doc;
+}
+
+static TemplateVariant renderDoc(const Definition *def,const QCString &file,
+                                 const QCString &relPath,const ParsedDoc &doc)
 {
   TemplateVariant result;
-  std::unique_ptr<IDocParser> parser { createDocParser() };
-  std::unique_ptr<DocRoot>    root   { validatingParseDoc(
-                                       *parser.get(),file,line,def,0,docStr,TRUE,FALSE,
-                                       QCString(),isBrief,FALSE,Config_getBool(MARKDOWN_SUPPORT))
-                                     };
   TextStream ts;
   switch (g_globals.outputFormat)
   {
@@ -1274,14 +1356,14 @@ static TemplateVariant parseDoc(const Definition *def,const QCString &file,int l
       {
         HtmlCodeGenerator codeGen(ts,relPath);
         HtmlDocVisitor visitor(ts,codeGen,def);
-        root->accept(&visitor);
+        doc.root->accept(&visitor);
       }
       break;
     case ContextOutputFormat_Latex:
       {
         LatexCodeGenerator codeGen(ts,relPath,file);
         LatexDocVisitor visitor(ts,codeGen,def->getDefFileExtension(),FALSE);
-        root->accept(&visitor);
+        doc.root->accept(&visitor);
       }
       break;
     // TODO: support other generators
@@ -1289,7 +1371,7 @@ static TemplateVariant parseDoc(const Definition *def,const QCString &file,int l
       err("context.cpp: output format not yet supported\n");
       break;
   }
-  bool isEmpty = root->isEmpty();
+  bool isEmpty = doc.root->isEmpty();
   if (isEmpty)
     result = "";
   else
@@ -1297,6 +1379,12 @@ static TemplateVariant parseDoc(const Definition *def,const QCString &file,int l
   return result;
 }
 
+static TemplateVariant parseDoc(const Definition *def,const QCString &file,int line,
+                                const QCString &relPath,const QCString &docStr,bool isBrief)
+{
+  return renderDoc(def,file,relPath,*parseDocTree(def,file,line,docStr,isBrief));
+}
+
 static TemplateVariant parseCode(const Definition *d,const QCString &scopeName,const QCString &relPath,
                                  const QCString &code,int startLine=-1,int endLine=-1,bool showLineNumbers=FALSE)
 {
@@ -1309,14 +1397,16 @@ static TemplateVariant parseCode(const Definition *d,const QCString &scopeName,c
       {
         HtmlCodeGenerator codeGen(t,relPath);
         intf->parseCode(codeGen,scopeName,code,d->getLanguage(),FALSE,QCString(),d->getBodyDef(),
-            startLine,endLine,TRUE,toMemberDef(d),showLineNumbers,d);
+            startLine,endLine,TRUE,toMemberDef(d),showLineNumbers,d,
+            FALSE); // the cross references were collected when writing the sources
       }
       break;
     case ContextOutputFormat_Latex:
       {
         LatexCodeGenerator codeGen(t,relPath,d->docFile());
         intf->parseCode(codeGen,scopeName,code,d->getLanguage(),FALSE,QCString(),d->getBodyDef(),
-            startLine,endLine,TRUE,toMemberDef(d),showLineNumbers,d);
+            startLine,endLine,TRUE,toMemberDef(d),showLineNumbers,d,
+            FALSE); // the cross references were collected when writing the sources
       }
       break;
     // TODO: support other generators
@@ -1350,7 +1440,7 @@ static TemplateVariant parseCode(const FileDef *fd,const QCString &relPath)
               0,                  // memberDef
               TRUE,               // showLineNumbers
               0,                  // searchCtx
-              TRUE                // collectXRefs, TODO: should become FALSE
+              FALSE               // collectXRefs, already collected when writing the sources
               );
       }
       break;
@@ -1369,7 +1459,7 @@ static TemplateVariant parseCode(const FileDef *fd,const QCString &relPath)
               0,                  // memberDef
               TRUE,               // showLineNumbers
               0,                  // searchCtx
-              TRUE                // collectXRefs, TODO: should become FALSE
+              FALSE               // collectXRefs, already collected when writing the sources
               );
       }
       break;
@@ -1394,7 +1484,7 @@ class DefinitionContext
       assert(d!=0);
     }
     virtual ~DefinitionContext() {}
-    void addBaseProperties(PropertyMapper<T> &inst)
+    static void addBaseProperties(PropertyMapper<T> &inst)
     {
       //%% string name: the name of the symbol
       inst.addProperty("name",&DefinitionContext::name);
@@ -1473,10 +1563,14 @@ class DefinitionContext
     TemplateVariant details() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.details || g_globals.outputFormat!=cache.detailsOutputFormat)
       {
-        cache.details.reset(new TemplateVariant(parseDoc(m_def,m_def->docFile(),m_def->docLine(),
-                                            relPathAsString(),m_def->documentation(),FALSE)));
+        if (!cache.detailsDoc)
+        {
+          cache.detailsDoc = parseDocTree(m_def,m_def->docFile(),m_def->docLine(),m_def->documentation(),FALSE);
+        }
+        cache.details.reset(new TemplateVariant(renderDoc(m_def,m_def->docFile(),relPathAsString(),*cache.detailsDoc)));
         cache.detailsOutputFormat = g_globals.outputFormat;
       }
       return *cache.details;
@@ -1484,12 +1578,16 @@ class DefinitionContext
     TemplateVariant brief() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.brief || g_globals.outputFormat!=cache.briefOutputFormat)
       {
         if (m_def->hasBriefDescription())
         {
-          cache.brief.reset(new TemplateVariant(parseDoc(m_def,m_def->briefFile(),m_def->briefLine(),
-                             relPathAsString(),m_def->briefDescription(),TRUE)));
+          if (!cache.briefDoc)
+          {
+            cache.briefDoc = parseDocTree(m_def,m_def->briefFile(),m_def->briefLine(),m_def->briefDescription(),TRUE);
+          }
+          cache.brief.reset(new TemplateVariant(renderDoc(m_def,m_def->briefFile(),relPathAsString(),*cache.briefDoc)));
           cache.briefOutputFormat = g_globals.outputFormat;
         }
         else
@@ -1502,12 +1600,16 @@ class DefinitionContext
     TemplateVariant inbodyDocs() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.inbodyDocs || g_globals.outputFormat!=cache.inbodyDocsOutputFormat)
       {
         if (!m_def->inbodyDocumentation().isEmpty())
         {
-          cache.inbodyDocs.reset(new TemplateVariant(parseDoc(m_def,m_def->inbodyFile(),m_def->inbodyLine(),
-                                           relPathAsString(),m_def->inbodyDocumentation(),FALSE)));
+          if (!cache.inbodyDocsDoc)
+          {
+            cache.inbodyDocsDoc = parseDocTree(m_def,m_def->inbodyFile(),m_def->inbodyLine(),m_def->inbodyDocumentation(),FALSE);
+          }
+          cache.inbodyDocs.reset(new TemplateVariant(renderDoc(m_def,m_def->inbodyFile(),relPathAsString(),*cache.inbodyDocsDoc)));
           cache.inbodyDocsOutputFormat = g_globals.outputFormat;
         }
         else
@@ -1519,7 +1621,7 @@ class DefinitionContext
     }
     TemplateVariant dynSectionId() const
     {
-      return g_globals.dynSectionId;
+      return t_dynSectionId;
     }
     TemplateVariant language() const
     {
@@ -1568,6 +1670,7 @@ class DefinitionContext
     TemplateVariant sourceDef() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (cache.sourceDef->count()==2)
       {
         return TemplateVariant(std::static_pointer_cast<TemplateListIntf>(cache.sourceDef));
@@ -1594,6 +1697,7 @@ class DefinitionContext
     TemplateVariant navigationPath() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.navPath)
       {
         TemplateListPtr list = TemplateList::alloc();
@@ -1664,10 +1768,15 @@ class DefinitionContext
       ContextOutputFormat        briefOutputFormat;
       std::unique_ptr<TemplateVariant> inbodyDocs;
       ContextOutputFormat        inbodyDocsOutputFormat;
+      // parsed once, rendered again for each output format
+      std::unique_ptr<ParsedDoc> detailsDoc;
+      std::unique_ptr<ParsedDoc> briefDoc;
+      std::unique_ptr<ParsedDoc> inbodyDocsDoc;
       TemplateListPtr            navPath;
       TemplateListPtr            sourceDef;
       TemplateStructPtr          fileLink;
       TemplateStructPtr          lineLink;
+      std::recursive_mutex mutex; // guards the lazily computed members
     };
 
   private:
@@ -1692,20 +1801,23 @@ class IncludeInfoContext::Private
       m_info(info),
       m_lang(lang)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("file",&Private::file);
         s_inst.addProperty("name",&Private::name);
         s_inst.addProperty("isImport",&Private::isImport);
         s_inst.addProperty("isLocal",&Private::isLocal);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -1721,6 +1833,7 @@ class IncludeInfoContext::Private
     }
     TemplateVariant file() const
     {
+      std::lock_guard<std::mutex> lock(m_mutex);
       if (!m_fileContext && m_info && m_info->fileDef)
       {
         m_fileContext = FileContext::alloc(m_info->fileDef);
@@ -1741,6 +1854,7 @@ class IncludeInfoContext::Private
   private:
     const IncludeInfo *m_info;
     mutable TemplateStructIntfPtr m_fileContext;
+    mutable std::mutex m_mutex;
     SrcLangExt m_lang;
     static PropertyMapper<IncludeInfoContext::Private> s_inst;
 };
@@ -1760,6 +1874,11 @@ TemplateVariant IncludeInfoContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant IncludeInfoContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector IncludeInfoContext::fields() const
 {
   return p->fields();
@@ -1816,8 +1935,8 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     Private(const ClassDef *cd) : DefinitionContext<ClassContext::Private>(cd),
        m_classDef(cd)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         addBaseProperties(s_inst);
         s_inst.addProperty("title",                     &Private::title);
@@ -1886,15 +2005,18 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
         s_inst.addProperty("additionalInheritedMembers",&Private::additionalInheritedMembers);
         s_inst.addProperty("isSimple",                  &Private::isSimple);
         s_inst.addProperty("categoryOf",                &Private::categoryOf);
-        init=TRUE;
-      }
-      if (!cd->cookie()) { cd->setCookie(new ClassContext::Private::Cachable(cd)); }
+      });
+      initCookie<ClassContext::Private::Cachable>(cd);
     }
     virtual ~Private() {}
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -1922,6 +2044,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant usedFiles() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.usedFiles)
       {
         cache.usedFiles = UsedFilesContext::alloc(m_classDef);
@@ -1931,6 +2054,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     DotClassGraph *getClassGraph() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.classGraph)
       {
         cache.classGraph.reset(new DotClassGraph(m_classDef,Inheritance));
@@ -1940,6 +2064,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     int numInheritanceNodes() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (cache.inheritanceNodes==-1)
       {
         cache.inheritanceNodes=m_classDef->countInheritanceNodes();
@@ -1981,7 +2106,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
               cg->writeGraph(t,GOF_BITMAP,EOF_Html,
                              g_globals.outputDir,
                              g_globals.outputDir+Portable::pathSeparator()+m_classDef->getOutputFileBase()+Doxygen::htmlFileExtension,
-                             relPathAsString(),TRUE,TRUE,g_globals.dynSectionId
+                             relPathAsString(),TRUE,TRUE,t_dynSectionId
                             );
             }
             break;
@@ -1990,7 +2115,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
               cg->writeGraph(t,GOF_EPS,EOF_LaTeX,
                              g_globals.outputDir,
                              g_globals.outputDir+Portable::pathSeparator()+m_classDef->getOutputFileBase()+".tex",
-                             relPathAsString(),TRUE,TRUE,g_globals.dynSectionId
+                             relPathAsString(),TRUE,TRUE,t_dynSectionId
                             );
             }
             break;
@@ -1999,7 +2124,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
       }
       else if (classGraphEnabled)
       {
@@ -2045,13 +2170,14 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
       }
       return TemplateVariant(t.str().c_str(),TRUE);
     }
     DotClassGraph *getCollaborationGraph() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.collaborationGraph)
       {
         cache.collaborationGraph.reset(new DotClassGraph(m_classDef,Collaboration));
@@ -2077,7 +2203,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
               cg->writeGraph(t,GOF_BITMAP,EOF_Html,
                              g_globals.outputDir,
                              g_globals.outputDir+Portable::pathSeparator()+m_classDef->getOutputFileBase()+Doxygen::htmlFileExtension,
-                             relPathAsString(),TRUE,TRUE,g_globals.dynSectionId
+                             relPathAsString(),TRUE,TRUE,t_dynSectionId
                             );
             }
             break;
@@ -2086,7 +2212,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
               cg->writeGraph(t,GOF_EPS,EOF_LaTeX,
                              g_globals.outputDir,
                              g_globals.outputDir+Portable::pathSeparator()+m_classDef->getOutputFileBase()+".tex",
-                             relPathAsString(),TRUE,TRUE,g_globals.dynSectionId
+                             relPathAsString(),TRUE,TRUE,t_dynSectionId
                             );
             }
             break;
@@ -2095,7 +2221,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
       }
       return TemplateVariant(t.str().c_str(),TRUE);
     }
@@ -2103,6 +2229,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant includeInfo() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.includeInfo && m_classDef->includeInfo())
       {
         cache.includeInfo = IncludeInfoContext::alloc(m_classDef->includeInfo(),m_classDef->getLanguage());
@@ -2119,6 +2246,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant inherits() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.inheritsList)
       {
         cache.inheritsList = InheritanceListContext::alloc(m_classDef->baseClasses(),TRUE);
@@ -2128,6 +2256,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant inheritedBy() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.inheritedByList)
       {
         cache.inheritedByList = InheritanceListContext::alloc(m_classDef->subClasses(),FALSE);
@@ -2321,6 +2450,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant classes() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.classes)
       {
         TemplateListPtr classList = TemplateList::alloc();
@@ -2338,6 +2468,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant innerClasses() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.innerClasses)
       {
         TemplateListPtr classList = TemplateList::alloc();
@@ -2399,6 +2530,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant templateDecls() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.templateDecls)
       {
         TemplateListPtr tl = TemplateList::alloc();
@@ -2412,6 +2544,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
       if (!m_classDef->typeConstraints().empty())
       {
         Cachable &cache = getCache();
+        std::lock_guard<std::recursive_mutex> lock(cache.mutex);
         if (!cache.typeConstraints && !m_classDef->typeConstraints().empty())
         {
           cache.typeConstraints = ArgumentListContext::alloc(m_classDef->typeConstraints(),m_classDef,relPathAsString());
@@ -2423,6 +2556,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant examples() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.examples)
       {
         TemplateListPtr exampleList = TemplateList::alloc();
@@ -2437,6 +2571,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
       if (ml)
       {
         Cachable &cache = getCache();
+        std::lock_guard<std::recursive_mutex> lock(cache.mutex);
         for (const auto &md : *ml)
         {
           if (md->isBriefSectionVisible())
@@ -2449,6 +2584,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant members() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.members)
       {
         addMembers(m_classDef,MemberListType_pubTypes);
@@ -2487,6 +2623,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant allMembersList() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.allMembersList)
       {
         TemplateListIntfPtr ml = AllMembersListContext::alloc(m_classDef->memberNameInfoLinkedMap());
@@ -2501,6 +2638,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant memberGroups() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.memberGroups)
       {
         if (!m_classDef->getMemberGroups().empty())
@@ -2517,6 +2655,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant additionalInheritedMembers() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.additionalInheritedMembers)
       {
         cache.additionalInheritedMembers = InheritedMemberInfoListContext::alloc();
@@ -2564,6 +2703,7 @@ class ClassContext::Private : public DefinitionContext<ClassContext::Private>
     TemplateVariant categoryOf() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.categoryOf && m_classDef->categoryOf())
       {
         cache.categoryOf = ClassContext::alloc(m_classDef->categoryOf());
@@ -2670,6 +2810,11 @@ TemplateVariant ClassContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant ClassContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ClassContext::fields() const
 {
   return p->fields();
@@ -2685,8 +2830,8 @@ class NamespaceContext::Private : public DefinitionContext<NamespaceContext::Pri
     Private(const NamespaceDef *nd) : DefinitionContext<NamespaceContext::Private>(nd),
                                 m_namespaceDef(nd)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         addBaseProperties(s_inst);
         s_inst.addProperty("title",                &Private::title);
@@ -2712,15 +2857,18 @@ class NamespaceContext::Private : public DefinitionContext<NamespaceContext::Pri
         s_inst.addProperty("detailedFunctions",    &Private::detailedFunctions);
         s_inst.addProperty("detailedVariables",    &Private::detailedVariables);
         s_inst.addProperty("inlineClasses",        &Private::inlineClasses);
-        init=TRUE;
-      }
-      if (!nd->cookie()) { nd->setCookie(new NamespaceContext::Private::Cachable(nd)); }
+      });
+      initCookie<NamespaceContext::Private::Cachable>(nd);
     }
     virtual ~Private() {}
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -2748,6 +2896,7 @@ class NamespaceContext::Private : public DefinitionContext<NamespaceContext::Pri
     TemplateVariant classes() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.classes)
       {
         static bool sliceOpt = Config_getBool(OPTIMIZE_OUTPUT_SLICE);
@@ -2772,6 +2921,7 @@ class NamespaceContext::Private : public DefinitionContext<NamespaceContext::Pri
     TemplateVariant namespaces() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.namespaces)
       {
         TemplateListPtr namespaceList = TemplateList::alloc();
@@ -2789,6 +2939,7 @@ class NamespaceContext::Private : public DefinitionContext<NamespaceContext::Pri
     TemplateVariant constantgroups() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.constantgroups)
       {
         TemplateListPtr namespaceList = TemplateList::alloc();
@@ -2856,6 +3007,7 @@ class NamespaceContext::Private : public DefinitionContext<NamespaceContext::Pri
     TemplateVariant memberGroups() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.memberGroups)
       {
         if (!m_namespaceDef->getMemberGroups().empty())
@@ -2902,6 +3054,7 @@ class NamespaceContext::Private : public DefinitionContext<NamespaceContext::Pri
     TemplateVariant inlineClasses() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.inlineClasses)
       {
         TemplateListPtr classList = TemplateList::alloc();
@@ -2968,6 +3121,11 @@ TemplateVariant NamespaceContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant NamespaceContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector NamespaceContext::fields() const
 {
   return p->fields();
@@ -2983,8 +3141,8 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     Private(const FileDef *fd) : DefinitionContext<FileContext::Private>(fd) , m_fileDef(fd)
     {
       if (fd==0) abort();
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         addBaseProperties(s_inst);
         s_inst.addProperty("title",                     &Private::title);
@@ -3020,15 +3178,18 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
         s_inst.addProperty("detailedVariables",         &Private::detailedVariables);
         s_inst.addProperty("inlineClasses",             &Private::inlineClasses);
         s_inst.addProperty("compoundType",              &Private::compoundType);
-        init=TRUE;
-      }
-      if (!fd->cookie()) { fd->setCookie(new FileContext::Private::Cachable(fd)); }
+      });
+      initCookie<FileContext::Private::Cachable>(fd);
     }
     virtual ~Private() {}
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -3052,6 +3213,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     TemplateVariant includeList() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.includeInfoList && !m_fileDef->includeFileList().empty())
       {
         cache.includeInfoList = IncludeInfoListContext::alloc(
@@ -3069,6 +3231,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     DotInclDepGraph *getIncludeGraph() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.includeGraph)
       {
         cache.includeGraph.reset(new DotInclDepGraph(m_fileDef,FALSE));
@@ -3095,7 +3258,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
               cg->writeGraph(t,GOF_BITMAP,EOF_Html,
                   g_globals.outputDir,
                   g_globals.outputDir+Portable::pathSeparator()+m_fileDef->getOutputFileBase()+Doxygen::htmlFileExtension,
-                  relPathAsString(),TRUE,g_globals.dynSectionId
+                  relPathAsString(),TRUE,t_dynSectionId
                   );
             }
             break;
@@ -3104,7 +3267,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
               cg->writeGraph(t,GOF_EPS,EOF_LaTeX,
                   g_globals.outputDir,
                   g_globals.outputDir+Portable::pathSeparator()+m_fileDef->getOutputFileBase()+".tex",
-                  relPathAsString(),TRUE,g_globals.dynSectionId
+                  relPathAsString(),TRUE,t_dynSectionId
                   );
             }
             break;
@@ -3113,13 +3276,14 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
       }
       return TemplateVariant(t.str().c_str(),TRUE);
     }
     DotInclDepGraph *getIncludedByGraph() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.includedByGraph)
       {
         cache.includedByGraph.reset(new DotInclDepGraph(m_fileDef,TRUE));
@@ -3146,7 +3310,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
               cg->writeGraph(t,GOF_BITMAP,EOF_Html,
                   g_globals.outputDir,
                   g_globals.outputDir+Portable::pathSeparator()+m_fileDef->getOutputFileBase()+Doxygen::htmlFileExtension,
-                  relPathAsString(),TRUE,g_globals.dynSectionId
+                  relPathAsString(),TRUE,t_dynSectionId
                   );
             }
             break;
@@ -3155,7 +3319,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
               cg->writeGraph(t,GOF_EPS,EOF_LaTeX,
                   g_globals.outputDir,
                   g_globals.outputDir+Portable::pathSeparator()+m_fileDef->getOutputFileBase()+".tex",
-                  relPathAsString(),TRUE,g_globals.dynSectionId
+                  relPathAsString(),TRUE,t_dynSectionId
                   );
             }
             break;
@@ -3164,7 +3328,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
       }
       return TemplateVariant(t.str().c_str(),TRUE);
     }
@@ -3179,6 +3343,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     TemplateVariant sources() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.sources)
       {
         if (m_fileDef->generateSourceFile())
@@ -3199,6 +3364,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     TemplateVariant classes() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.classes)
       {
         TemplateListPtr classList = TemplateList::alloc();
@@ -3216,6 +3382,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     TemplateVariant namespaces() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.namespaces)
       {
         TemplateListPtr namespaceList = TemplateList::alloc();
@@ -3233,6 +3400,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     TemplateVariant constantgroups() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.constantgroups)
       {
         TemplateListPtr namespaceList = TemplateList::alloc();
@@ -3304,6 +3472,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     TemplateVariant memberGroups() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.memberGroups)
       {
         if (!m_fileDef->getMemberGroups().empty())
@@ -3351,6 +3520,7 @@ class FileContext::Private : public DefinitionContext<FileContext::Private>
     TemplateVariant inlineClasses() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.inlineClasses)
       {
         TemplateListPtr classList = TemplateList::alloc();
@@ -3427,6 +3597,11 @@ TemplateVariant FileContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant FileContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector FileContext::fields() const
 {
   return p->fields();
@@ -3441,8 +3616,8 @@ class DirContext::Private : public DefinitionContext<DirContext::Private>
   public:
     Private(const DirDef *dd) : DefinitionContext<DirContext::Private>(dd) , m_dirDef(dd)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         addBaseProperties(s_inst);
         s_inst.addProperty("title",         &Private::title);
@@ -3455,15 +3630,18 @@ class DirContext::Private : public DefinitionContext<DirContext::Private>
         s_inst.addProperty("hasDirGraph",   &Private::hasDirGraph);
         s_inst.addProperty("dirGraph",      &Private::dirGraph);
         s_inst.addProperty("compoundType",  &Private::compoundType);
-        init=TRUE;
-      }
-      if (!dd->cookie()) { dd->setCookie(new DirContext::Private::Cachable(dd)); }
+      });
+      initCookie<DirContext::Private::Cachable>(dd);
     }
     virtual ~Private() {}
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -3487,6 +3665,7 @@ class DirContext::Private : public DefinitionContext<DirContext::Private>
     TemplateVariant dirs() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.dirs)
       {
         cache.dirs = TemplateList::alloc();
@@ -3500,6 +3679,7 @@ class DirContext::Private : public DefinitionContext<DirContext::Private>
     TemplateVariant files() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.files)
       {
         cache.files = TemplateList::alloc();
@@ -3525,6 +3705,7 @@ class DirContext::Private : public DefinitionContext<DirContext::Private>
     DotDirDeps *getDirDepsGraph() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.dirDepsGraph)
       {
         cache.dirDepsGraph.reset(new DotDirDeps(m_dirDef));
@@ -3561,7 +3742,7 @@ class DirContext::Private : public DefinitionContext<DirContext::Private>
                                 g_globals.outputDir+Portable::pathSeparator()+m_dirDef->getOutputFileBase()+Doxygen::htmlFileExtension,
                                 relPathAsString(),
                                 TRUE,
-                                g_globals.dynSectionId,
+                                t_dynSectionId,
                                 FALSE);
             }
             break;
@@ -3573,7 +3754,7 @@ class DirContext::Private : public DefinitionContext<DirContext::Private>
                                 g_globals.outputDir+Portable::pathSeparator()+m_dirDef->getOutputFileBase()+".tex",
                                 relPathAsString(),
                                 TRUE,
-                                g_globals.dynSectionId,
+                                t_dynSectionId,
                                 FALSE);
             }
             break;
@@ -3582,7 +3763,7 @@ class DirContext::Private : public DefinitionContext<DirContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
       }
       return TemplateVariant(t.str().c_str(),TRUE);
     }
@@ -3621,6 +3802,11 @@ TemplateVariant DirContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant DirContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector DirContext::fields() const
 {
   return p->fields();
@@ -3637,23 +3823,26 @@ class PageContext::Private : public DefinitionContext<PageContext::Private>
       : DefinitionContext<PageContext::Private>(pd) , m_pageDef(pd), m_isMainPage(isMainPage),
         m_isExample(isExample)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         addBaseProperties(s_inst);
         s_inst.addProperty("title",       &Private::title);
         s_inst.addProperty("highlight",   &Private::highlight);
         s_inst.addProperty("subhighlight",&Private::subHighlight);
         s_inst.addProperty("example",     &Private::example);
-        init=TRUE;
-      }
-      if (!pd->cookie()) { pd->setCookie(new PageContext::Private::Cachable(pd)); }
+      });
+      initCookie<PageContext::Private::Cachable>(pd);
     }
     virtual ~Private() {}
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -3723,11 +3912,16 @@ class PageContext::Private : public DefinitionContext<PageContext::Private>
       if (m_isExample)
       {
         Cachable &cache = getCache();
+        std::lock_guard<std::recursive_mutex> lock(cache.mutex);
         if (!cache.example || g_globals.outputFormat!=cache.exampleOutputFormat)
         {
+          if (!cache.exampleDoc)
+          {
+            cache.exampleDoc = parseDocTree(m_pageDef,m_pageDef->docFile(),m_pageDef->docLine(),
+                                            "\\include "+m_pageDef->name(),FALSE);
+          }
           cache.example.reset(new TemplateVariant(
-                parseDoc(m_pageDef,m_pageDef->docFile(),m_pageDef->docLine(),
-                  relPathAsString(),"\\include "+m_pageDef->name(),FALSE)));
+                renderDoc(m_pageDef,m_pageDef->docFile(),relPathAsString(),*cache.exampleDoc)));
           cache.exampleOutputFormat = g_globals.outputFormat;
         }
         return *cache.example;
@@ -3745,6 +3939,7 @@ class PageContext::Private : public DefinitionContext<PageContext::Private>
                               exampleOutputFormat(ContextOutputFormat_Unspecified) { }
       std::unique_ptr<TemplateVariant> example;
       ContextOutputFormat        exampleOutputFormat;
+      std::unique_ptr<ParsedDoc> exampleDoc;
     };
     Cachable &getCache() const
     {
@@ -3773,6 +3968,11 @@ TemplateVariant PageContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant PageContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector PageContext::fields() const
 {
   return p->fields();
@@ -3926,8 +4126,7 @@ class TextGeneratorFactory
   public:
     static TextGeneratorFactory *instance()
     {
-      static TextGeneratorFactory *instance = 0;
-      if (instance==0) instance = new TextGeneratorFactory;
+      static TextGeneratorFactory *instance = new TextGeneratorFactory;
       return instance;
     }
     TextGeneratorIntf *create(TextStream &ts,const QCString &relPath)
@@ -3971,8 +4170,8 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
   public:
     Private(const MemberDef *md) : DefinitionContext<MemberContext::Private>(md) , m_memberDef(md)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         addBaseProperties(s_inst);
         s_inst.addProperty("isSignal",            &Private::isSignal);
@@ -4097,9 +4296,8 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
         s_inst.addProperty("type",                &Private::type);
         s_inst.addProperty("detailsVisibleFor",   &Private::detailsVisibleFor);
         s_inst.addProperty("nameWithContextFor",  &Private::nameWithContextFor);
-        init=TRUE;
-      }
-      if (!md->cookie()) { md->setCookie(new MemberContext::Private::Cachable(md)); }
+      });
+      initCookie<MemberContext::Private::Cachable>(md);
 
       m_propertyAttrs = TemplateList::alloc();
       if (md->isProperty())
@@ -4124,6 +4322,10 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -4135,6 +4337,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant declType() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.declTypeParsed)
       {
         cache.declType=createLinkedText(m_memberDef,relPathAsString(),m_memberDef->getDeclType());
@@ -4149,6 +4352,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant declArgs() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.declArgsParsed)
       {
         cache.declArgs=createLinkedText(m_memberDef,relPathAsString(),m_memberDef->argsString());
@@ -4427,6 +4631,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant initializerAsCode() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.initializerParsed)
       {
         QCString scopeName;
@@ -4456,6 +4661,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant anonymousType() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.anonymousType)
       {
         const ClassDef *cd = m_memberDef->getClassDefOfAnonymousType();
@@ -4476,6 +4682,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant anonymousMember() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.anonymousMember)
       {
         MemberDef *md = m_memberDef->fromAnonymousMember();
@@ -4514,6 +4721,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
       if (m_memberDef->isEnumerate())
       {
         Cachable &cache = getCache();
+        std::lock_guard<std::recursive_mutex> lock(cache.mutex);
         if (!cache.enumValues)
         {
           cache.enumValues = MemberListContext::alloc(m_memberDef->enumFieldList());
@@ -4528,6 +4736,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant templateArgs() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.templateArgs && !m_memberDef->templateArguments().empty())
       {
         cache.templateArgs = ArgumentListContext::alloc(m_memberDef->templateArguments(),m_memberDef,relPathAsString());
@@ -4561,6 +4770,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant getClass() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.classDef && m_memberDef->getClassDef())
       {
         cache.classDef = ClassContext::alloc(m_memberDef->getClassDef());
@@ -4577,6 +4787,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant category() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.category && m_memberDef->category())
       {
         cache.category = ClassContext::alloc(m_memberDef->category());
@@ -4593,6 +4804,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant categoryRelation() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.categoryRelation && m_memberDef->categoryRelation())
       {
         cache.categoryRelation = MemberContext::alloc(m_memberDef->categoryRelation());
@@ -4609,6 +4821,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant getFile() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.fileDef && m_memberDef->getFileDef())
       {
         cache.fileDef = FileContext::alloc(m_memberDef->getFileDef());
@@ -4625,6 +4838,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant getNamespace() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.namespaceDef && m_memberDef->getNamespaceDef())
       {
         cache.namespaceDef = NamespaceContext::alloc(m_memberDef->getNamespaceDef());
@@ -4651,6 +4865,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant parameters() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.arguments)
       {
         const ArgumentList &defArgList = getDefArgList();
@@ -4737,6 +4952,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant templateDecls() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.templateDecls)
       {
         cache.templateDecls = TemplateList::alloc();
@@ -4747,6 +4963,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant labels() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.labels)
       {
         StringVector sl = m_memberDef->getLabels(m_memberDef->getOuterScope());
@@ -4762,6 +4979,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant paramDocs() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.paramDocs)
       {
         if (m_memberDef->argumentList().hasDocumentation())
@@ -4790,6 +5008,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant implements() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.implements)
       {
         const MemberDef *md = m_memberDef->reimplements();
@@ -4809,6 +5028,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant reimplements() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.reimplements)
       {
         const MemberDef *md = m_memberDef->reimplements();
@@ -4828,6 +5048,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant implementedBy() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.implementedBy)
       {
         cache.implementedBy = TemplateList::alloc();
@@ -4846,6 +5067,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant reimplementedBy() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.reimplementedBy)
       {
         cache.reimplementedBy = TemplateList::alloc();
@@ -4881,6 +5103,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant examples() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.examples)
       {
         cache.examples = TemplateList::alloc();
@@ -4891,6 +5114,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant typeConstraints() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (cache.typeConstraints && !m_memberDef->typeConstraints().empty())
       {
         cache.typeConstraints = ArgumentListContext::alloc(m_memberDef->typeConstraints(),m_memberDef,relPathAsString());
@@ -4919,6 +5143,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant sourceRefs() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.sourceRefs)
       {
         cache.sourceRefs = MemberListContext::alloc(m_memberDef->getReferencesMembers());
@@ -4928,6 +5153,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant sourceRefBys() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.sourceRefBys)
       {
         cache.sourceRefBys = MemberListContext::alloc(m_memberDef->getReferencedByMembers());
@@ -4941,6 +5167,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     TemplateVariant sourceCode() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.sourceCodeParsed)
       {
         QCString codeFragment;
@@ -4971,6 +5198,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     DotCallGraph *getCallGraph() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.callGraph)
       {
         cache.callGraph.reset(new DotCallGraph(m_memberDef,FALSE));
@@ -5005,7 +5233,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
               cg->writeGraph(t,GOF_BITMAP,EOF_Html,
                   g_globals.outputDir,
                   g_globals.outputDir+Portable::pathSeparator()+m_memberDef->getOutputFileBase()+Doxygen::htmlFileExtension,
-                  relPathAsString(),TRUE,g_globals.dynSectionId
+                  relPathAsString(),TRUE,t_dynSectionId
                   );
             }
             break;
@@ -5014,7 +5242,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
               cg->writeGraph(t,GOF_EPS,EOF_LaTeX,
                   g_globals.outputDir,
                   g_globals.outputDir+Portable::pathSeparator()+m_memberDef->getOutputFileBase()+".tex",
-                  relPathAsString(),TRUE,g_globals.dynSectionId
+                  relPathAsString(),TRUE,t_dynSectionId
                   );
             }
             break;
@@ -5023,7 +5251,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
         return TemplateVariant(t.str().c_str(),TRUE);
       }
       else
@@ -5042,6 +5270,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
     DotCallGraph *getCallerGraph() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.callerGraph)
       {
         cache.callerGraph.reset(new DotCallGraph(m_memberDef,TRUE));
@@ -5076,7 +5305,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
               cg->writeGraph(t,GOF_BITMAP,EOF_Html,
                   g_globals.outputDir,
                   g_globals.outputDir+Portable::pathSeparator()+m_memberDef->getOutputFileBase()+Doxygen::htmlFileExtension,
-                  relPathAsString(),TRUE,g_globals.dynSectionId
+                  relPathAsString(),TRUE,t_dynSectionId
                   );
             }
             break;
@@ -5085,7 +5314,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
               cg->writeGraph(t,GOF_EPS,EOF_LaTeX,
                   g_globals.outputDir,
                   g_globals.outputDir+Portable::pathSeparator()+m_memberDef->getOutputFileBase()+".tex",
-                  relPathAsString(),TRUE,g_globals.dynSectionId
+                  relPathAsString(),TRUE,t_dynSectionId
                   );
             }
             break;
@@ -5094,7 +5323,7 @@ class MemberContext::Private : public DefinitionContext<MemberContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
         return TemplateVariant(t.str().c_str(),TRUE);
       }
       else
@@ -5233,6 +5462,11 @@ TemplateVariant MemberContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant MemberContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector MemberContext::fields() const
 {
   return p->fields();
@@ -5248,8 +5482,8 @@ class ConceptContext::Private : public DefinitionContext<ConceptContext::Private
     Private(const ConceptDef *cd) : DefinitionContext<ConceptContext::Private>(cd),
        m_conceptDef(cd)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         addBaseProperties(s_inst);
         s_inst.addProperty("title",                     &Private::title);
@@ -5260,15 +5494,18 @@ class ConceptContext::Private : public DefinitionContext<ConceptContext::Private
         s_inst.addProperty("templateDecls",             &Private::templateDecls);
         s_inst.addProperty("initializer",               &Private::initializer);
         s_inst.addProperty("initializerAsCode",         &Private::initializerAsCode);
-        init=TRUE;
-      }
-      if (!cd->cookie()) { cd->setCookie(new ConceptContext::Private::Cachable(cd)); }
+      });
+      initCookie<ConceptContext::Private::Cachable>(cd);
     }
     virtual ~Private() {}
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -5292,6 +5529,7 @@ class ConceptContext::Private : public DefinitionContext<ConceptContext::Private
     TemplateVariant includeInfo() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.includeInfo && m_conceptDef->includeInfo())
       {
         cache.includeInfo = IncludeInfoContext::alloc(m_conceptDef->includeInfo(),m_conceptDef->getLanguage());
@@ -5317,6 +5555,7 @@ class ConceptContext::Private : public DefinitionContext<ConceptContext::Private
     TemplateVariant templateDecls() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.templateDecls)
       {
         cache.templateDecls = TemplateList::alloc();
@@ -5331,6 +5570,7 @@ class ConceptContext::Private : public DefinitionContext<ConceptContext::Private
     TemplateVariant initializerAsCode() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.initializerParsed)
       {
         QCString scopeName;
@@ -5381,6 +5621,11 @@ TemplateVariant ConceptContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant ConceptContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ConceptContext::fields() const
 {
   return p->fields();
@@ -5395,8 +5640,8 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
   public:
     Private(const GroupDef *gd) : DefinitionContext<ModuleContext::Private>(gd) , m_groupDef(gd)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         addBaseProperties(s_inst);
         s_inst.addProperty("title",                     &Private::title);
@@ -5441,15 +5686,18 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
         s_inst.addProperty("detailedFriends",           &Private::detailedFriends);
         s_inst.addProperty("inlineClasses",             &Private::inlineClasses);
         s_inst.addProperty("compoundType",              &Private::compoundType);
-        init=TRUE;
-      }
-      if (!gd->cookie()) { gd->setCookie(new ModuleContext::Private::Cachable(gd)); }
+      });
+      initCookie<ModuleContext::Private::Cachable>(gd);
     }
     virtual ~Private() {}
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -5469,6 +5717,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     DotGroupCollaboration *getGroupGraph() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.groupGraph)
       {
         cache.groupGraph.reset(new DotGroupCollaboration(m_groupDef));
@@ -5505,7 +5754,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
                                 g_globals.outputDir+Portable::pathSeparator()+m_groupDef->getOutputFileBase()+Doxygen::htmlFileExtension,
                                 relPathAsString(),
                                 TRUE,
-                                g_globals.dynSectionId);
+                                t_dynSectionId);
             }
             break;
           case ContextOutputFormat_Latex:
@@ -5516,7 +5765,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
                                 g_globals.outputDir+Portable::pathSeparator()+m_groupDef->getOutputFileBase()+".tex",
                                 relPathAsString(),
                                 TRUE,
-                                g_globals.dynSectionId);
+                                t_dynSectionId);
             }
             break;
             // TODO: support other generators
@@ -5524,7 +5773,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
             err("context.cpp: output format not yet supported\n");
             break;
         }
-        g_globals.dynSectionId++;
+        t_dynSectionId++;
       }
       return TemplateVariant(t.str().c_str(),TRUE);
     }
@@ -5535,6 +5784,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant modules() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.modules)
       {
         TemplateListPtr moduleList = TemplateList::alloc();
@@ -5552,6 +5802,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant examples() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.examples)
       {
         TemplateListPtr exampleList = TemplateList::alloc();
@@ -5566,6 +5817,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant pages() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.pages)
       {
         TemplateListPtr pageList = TemplateList::alloc();
@@ -5580,6 +5832,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant dirs() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.dirs)
       {
         TemplateListPtr dirList = TemplateList::alloc();
@@ -5594,6 +5847,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant files() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.files)
       {
         TemplateListPtr fileList = TemplateList::alloc();
@@ -5608,6 +5862,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant classes() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.classes)
       {
         TemplateListPtr classList = TemplateList::alloc();
@@ -5625,6 +5880,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant namespaces() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.namespaces)
       {
         TemplateListPtr namespaceList = TemplateList::alloc();
@@ -5642,6 +5898,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant constantgroups() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.constantgroups)
       {
         TemplateListPtr namespaceList = TemplateList::alloc();
@@ -5738,6 +5995,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant memberGroups() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.memberGroups)
       {
         if (!m_groupDef->getMemberGroups().empty())
@@ -5810,6 +6068,7 @@ class ModuleContext::Private : public DefinitionContext<ModuleContext::Private>
     TemplateVariant inlineClasses() const
     {
       Cachable &cache = getCache();
+      std::lock_guard<std::recursive_mutex> lock(cache.mutex);
       if (!cache.inlineClasses)
       {
         TemplateListPtr classList = TemplateList::alloc();
@@ -5899,6 +6158,11 @@ TemplateVariant ModuleContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant ModuleContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ModuleContext::fields() const
 {
   return p->fields();
@@ -5964,8 +6228,8 @@ class ClassIndexContext::Private
   public:
     Private()
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("list",        &Private::list);
         s_inst.addProperty("fileName",    &Private::fileName);
@@ -5973,19 +6237,23 @@ class ClassIndexContext::Private
         s_inst.addProperty("highlight",   &Private::highlight);
         s_inst.addProperty("subhighlight",&Private::subhighlight);
         s_inst.addProperty("title",       &Private::title);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
     }
     TemplateVariant list() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.classes)
       {
         TemplateListPtr classList = TemplateList::alloc();
@@ -6048,6 +6316,7 @@ class ClassIndexContext::Private
     struct Cachable
     {
       TemplateListPtr classes;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<ClassIndexContext::Private> s_inst;
@@ -6069,6 +6338,11 @@ TemplateVariant ClassIndexContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant ClassIndexContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ClassIndexContext::fields() const
 {
   return p->fields();
@@ -6158,8 +6432,8 @@ class ClassHierarchyContext::Private
       ctx->addClassHierarchy(*Doxygen::classLinkedMap,visitedClasses);
       ctx->addClassHierarchy(*Doxygen::hiddenClassLinkedMap,visitedClasses);
       //%% ClassInheritance tree
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("tree",            &Private::tree);
         s_inst.addProperty("fileName",        &Private::fileName);
@@ -6170,13 +6444,16 @@ class ClassHierarchyContext::Private
         s_inst.addProperty("preferredDepth",  &Private::preferredDepth);
         s_inst.addProperty("maxDepth",        &Private::maxDepth);
         s_inst.addProperty("diagrams",        &Private::diagrams);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -6203,6 +6480,7 @@ class ClassHierarchyContext::Private
     }
     DotGfxHierarchyTable *getHierarchy() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.hierarchy)
       {
         m_cache.hierarchy.reset(new DotGfxHierarchyTable());
@@ -6211,6 +6489,7 @@ class ClassHierarchyContext::Private
     }
     TemplateVariant diagrams() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.diagrams)
       {
         TemplateListPtr diagrams = TemplateList::alloc();
@@ -6238,6 +6517,7 @@ class ClassHierarchyContext::Private
     }
     TemplateVariant maxDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.maxDepthComputed)
       {
         m_cache.maxDepth = computeMaxDepth(m_classTree);
@@ -6247,6 +6527,7 @@ class ClassHierarchyContext::Private
     }
     TemplateVariant preferredDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.preferredDepthComputed)
       {
         m_cache.preferredDepth = computePreferredDepth(m_classTree,maxDepth().toInt());
@@ -6266,6 +6547,7 @@ class ClassHierarchyContext::Private
       bool  preferredDepthComputed;
       TemplateListPtr diagrams;
       std::unique_ptr<DotGfxHierarchyTable> hierarchy;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<ClassHierarchyContext::Private> s_inst;
@@ -6287,6 +6569,11 @@ TemplateVariant ClassHierarchyContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant ClassHierarchyContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ClassHierarchyContext::fields() const
 {
   return p->fields();
@@ -6308,8 +6595,8 @@ class NestingNodeContext::Private
     {
       m_children = std::dynamic_pointer_cast<NestingContext>(NestingContext::alloc(thisNode,m_type,level+1));
       m_members = std::dynamic_pointer_cast<NestingContext>(NestingContext::alloc(thisNode,m_type,level+1));
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         //%% bool is_leaf_node: true if this node does not have any children
         s_inst.addProperty("is_leaf_node",&Private::isLeafNode);
@@ -6346,8 +6633,7 @@ class NestingNodeContext::Private
         s_inst.addProperty("fileName",&Private::fileName);
         s_inst.addProperty("isReference",&Private::isReference);
         s_inst.addProperty("externalReference",&Private::externalReference);
-        init=TRUE;
-      }
+      });
 
       addNamespaces(addCls,addCps,visitedClasses);
       addClasses(inherit,hideSuper,visitedClasses);
@@ -6360,6 +6646,10 @@ class NestingNodeContext::Private
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -6378,6 +6668,7 @@ class NestingNodeContext::Private
     }
     TemplateVariant getClass() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.classContext && m_def->definitionType()==Definition::TypeClass)
       {
         m_cache.classContext = ClassContext::alloc(toClassDef(m_def));
@@ -6393,6 +6684,7 @@ class NestingNodeContext::Private
     }
     TemplateVariant getNamespace() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.namespaceContext && m_def->definitionType()==Definition::TypeNamespace)
       {
         m_cache.namespaceContext = NamespaceContext::alloc(toNamespaceDef(m_def));
@@ -6408,6 +6700,7 @@ class NestingNodeContext::Private
     }
     TemplateVariant getDir() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.dirContext && m_def->definitionType()==Definition::TypeDir)
       {
         m_cache.dirContext = DirContext::alloc(toDirDef(m_def));
@@ -6423,6 +6716,7 @@ class NestingNodeContext::Private
     }
     TemplateVariant getFile() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.fileContext && m_def->definitionType()==Definition::TypeFile)
       {
         m_cache.fileContext = FileContext::alloc(toFileDef(m_def));
@@ -6438,6 +6732,7 @@ class NestingNodeContext::Private
     }
     TemplateVariant getPage() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.pageContext && m_def->definitionType()==Definition::TypePage)
       {
         m_cache.pageContext = PageContext::alloc(toPageDef(m_def),FALSE,FALSE);
@@ -6453,6 +6748,7 @@ class NestingNodeContext::Private
     }
     TemplateVariant getModule() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.moduleContext && m_def->definitionType()==Definition::TypeGroup)
       {
         m_cache.moduleContext = ModuleContext::alloc(toGroupDef(m_def));
@@ -6468,6 +6764,7 @@ class NestingNodeContext::Private
     }
     TemplateVariant getMember() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.memberContext && m_def->definitionType()==Definition::TypeMember)
       {
         m_cache.memberContext = MemberContext::alloc(toMemberDef(m_def));
@@ -6515,6 +6812,7 @@ class NestingNodeContext::Private
     }
     TemplateVariant brief() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.brief)
       {
         if (m_def->hasBriefDescription())
@@ -6748,6 +7046,7 @@ class NestingNodeContext::Private
       TemplateStructIntfPtr moduleContext;
       TemplateStructIntfPtr memberContext;
       std::unique_ptr<TemplateVariant>  brief;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<NestingNodeContext::Private> s_inst;
@@ -6775,6 +7074,11 @@ TemplateVariant NestingNodeContext::get(const QCString &n) const
   return p->get(n);
 }
 
+TemplateVariant NestingNodeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector NestingNodeContext::fields() const
 {
   return p->fields();
@@ -7190,8 +7494,8 @@ class ClassTreeContext::Private
       ctx->addNamespaces(*Doxygen::namespaceLinkedMap,TRUE,TRUE,FALSE,visitedClasses);
       ctx->addClasses(*Doxygen::classLinkedMap,TRUE,visitedClasses);
       //%% Nesting tree
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("tree",          &Private::tree);
         s_inst.addProperty("fileName",      &Private::fileName);
@@ -7201,13 +7505,16 @@ class ClassTreeContext::Private
         s_inst.addProperty("title",         &Private::title);
         s_inst.addProperty("preferredDepth",&Private::preferredDepth);
         s_inst.addProperty("maxDepth",      &Private::maxDepth);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -7251,6 +7558,7 @@ class ClassTreeContext::Private
     }
     TemplateVariant maxDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.maxDepthComputed)
       {
         m_cache.maxDepth = computeMaxDepth(m_classTree);
@@ -7260,6 +7568,7 @@ class ClassTreeContext::Private
     }
     TemplateVariant preferredDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.preferredDepthComputed)
       {
         m_cache.preferredDepth = computePreferredDepth(m_classTree,maxDepth().toInt());
@@ -7277,6 +7586,7 @@ class ClassTreeContext::Private
       bool  maxDepthComputed;
       int   preferredDepth;
       bool  preferredDepthComputed;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<ClassTreeContext::Private> s_inst;
@@ -7298,6 +7608,11 @@ TemplateVariant ClassTreeContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant ClassTreeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ClassTreeContext::fields() const
 {
   return p->fields();
@@ -7403,8 +7718,8 @@ class NamespaceTreeContext::Private
       ClassDefSet visitedClasses;
       ctx->addNamespaces(*Doxygen::namespaceLinkedMap,TRUE,FALSE,TRUE,visitedClasses);
       //%% Nesting tree
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("tree",          &Private::tree);
         s_inst.addProperty("fileName",      &Private::fileName);
@@ -7414,13 +7729,16 @@ class NamespaceTreeContext::Private
         s_inst.addProperty("title",         &Private::title);
         s_inst.addProperty("preferredDepth",&Private::preferredDepth);
         s_inst.addProperty("maxDepth",      &Private::maxDepth);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -7467,6 +7785,7 @@ class NamespaceTreeContext::Private
     }
     TemplateVariant maxDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.maxDepthComputed)
       {
         m_cache.maxDepth = computeMaxDepth(m_namespaceTree);
@@ -7476,6 +7795,7 @@ class NamespaceTreeContext::Private
     }
     TemplateVariant preferredDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.preferredDepthComputed)
       {
         m_cache.preferredDepth = computePreferredDepth(m_namespaceTree,maxDepth().toInt());
@@ -7493,6 +7813,7 @@ class NamespaceTreeContext::Private
       bool  maxDepthComputed;
       int   preferredDepth;
       bool  preferredDepthComputed;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<NamespaceTreeContext::Private> s_inst;
@@ -7514,6 +7835,11 @@ TemplateVariant NamespaceTreeContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant NamespaceTreeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector NamespaceTreeContext::fields() const
 {
   return p->fields();
@@ -7677,8 +8003,8 @@ class FileTreeContext::Private
         ctx->addFiles(*Doxygen::inputNameLinkedMap,visitedClasses);
       }
       //%% DirFile tree:
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("tree",          &Private::tree);
         s_inst.addProperty("fileName",      &Private::fileName);
@@ -7688,13 +8014,16 @@ class FileTreeContext::Private
         s_inst.addProperty("title",         &Private::title);
         s_inst.addProperty("preferredDepth",&Private::preferredDepth);
         s_inst.addProperty("maxDepth",      &Private::maxDepth);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -7725,6 +8054,7 @@ class FileTreeContext::Private
     }
     TemplateVariant maxDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.maxDepthComputed)
       {
         m_cache.maxDepth = computeMaxDepth(m_dirFileTree);
@@ -7734,6 +8064,7 @@ class FileTreeContext::Private
     }
     TemplateVariant preferredDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.preferredDepthComputed)
       {
         m_cache.preferredDepth = computePreferredDepth(m_dirFileTree,maxDepth().toInt());
@@ -7751,6 +8082,7 @@ class FileTreeContext::Private
       bool  maxDepthComputed;
       int   preferredDepth;
       bool  preferredDepthComputed;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<FileTreeContext::Private> s_inst;
@@ -7772,6 +8104,11 @@ TemplateVariant FileTreeContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant FileTreeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector FileTreeContext::fields() const
 {
   return p->fields();
@@ -7793,8 +8130,8 @@ class PageTreeContext::Private
       ctx->addPages(pages,TRUE,visitedClasses);
 
       //%% PageNodeList tree:
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("tree",          &Private::tree);
         s_inst.addProperty("fileName",      &Private::fileName);
@@ -7804,13 +8141,16 @@ class PageTreeContext::Private
         s_inst.addProperty("title",         &Private::title);
         s_inst.addProperty("preferredDepth",&Private::preferredDepth);
         s_inst.addProperty("maxDepth",      &Private::maxDepth);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -7841,6 +8181,7 @@ class PageTreeContext::Private
     }
     TemplateVariant maxDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.maxDepthComputed)
       {
         m_cache.maxDepth = computeMaxDepth(m_pageTree);
@@ -7850,6 +8191,7 @@ class PageTreeContext::Private
     }
     TemplateVariant preferredDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.preferredDepthComputed)
       {
         m_cache.preferredDepth = computePreferredDepth(m_pageTree,maxDepth().toInt());
@@ -7867,6 +8209,7 @@ class PageTreeContext::Private
       bool  maxDepthComputed;
       int   preferredDepth;
       bool  preferredDepthComputed;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<PageTreeContext::Private> s_inst;
@@ -7888,6 +8231,11 @@ TemplateVariant PageTreeContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant PageTreeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector PageTreeContext::fields() const
 {
   return p->fields();
@@ -8038,8 +8386,8 @@ class ConceptTreeContext::Private
       ctx->addConcepts(*Doxygen::conceptLinkedMap,TRUE,visitedClasses);
 
       //%% ConceptList tree:
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("tree",          &Private::tree);
         s_inst.addProperty("fileName",      &Private::fileName);
@@ -8049,13 +8397,16 @@ class ConceptTreeContext::Private
         s_inst.addProperty("title",         &Private::title);
         s_inst.addProperty("preferredDepth",&Private::preferredDepth);
         s_inst.addProperty("maxDepth",      &Private::maxDepth);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -8086,6 +8437,7 @@ class ConceptTreeContext::Private
     }
     TemplateVariant maxDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.maxDepthComputed)
       {
         m_cache.maxDepth = computeMaxDepth(m_conceptTree);
@@ -8095,6 +8447,7 @@ class ConceptTreeContext::Private
     }
     TemplateVariant preferredDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.preferredDepthComputed)
       {
         m_cache.preferredDepth = computePreferredDepth(m_conceptTree,maxDepth().toInt());
@@ -8112,6 +8465,7 @@ class ConceptTreeContext::Private
       bool  maxDepthComputed;
       int   preferredDepth;
       bool  preferredDepthComputed;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<ConceptTreeContext::Private> s_inst;
@@ -8133,6 +8487,11 @@ TemplateVariant ConceptTreeContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant ConceptTreeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ConceptTreeContext::fields() const
 {
   return p->fields();
@@ -8154,8 +8513,8 @@ class ModuleTreeContext::Private
       ctx->addModules(*Doxygen::groupLinkedMap,visitedClasses);
 
       //%% ModuleList tree:
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("tree",          &Private::tree);
         s_inst.addProperty("fileName",      &Private::fileName);
@@ -8165,13 +8524,16 @@ class ModuleTreeContext::Private
         s_inst.addProperty("title",         &Private::title);
         s_inst.addProperty("preferredDepth",&Private::preferredDepth);
         s_inst.addProperty("maxDepth",      &Private::maxDepth);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -8202,6 +8564,7 @@ class ModuleTreeContext::Private
     }
     TemplateVariant maxDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.maxDepthComputed)
       {
         m_cache.maxDepth = computeMaxDepth(m_moduleTree);
@@ -8211,6 +8574,7 @@ class ModuleTreeContext::Private
     }
     TemplateVariant preferredDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.preferredDepthComputed)
       {
         m_cache.preferredDepth = computePreferredDepth(m_moduleTree,maxDepth().toInt());
@@ -8228,6 +8592,7 @@ class ModuleTreeContext::Private
       bool  maxDepthComputed;
       int   preferredDepth;
       bool  preferredDepthComputed;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<ModuleTreeContext::Private> s_inst;
@@ -8249,6 +8614,11 @@ TemplateVariant ModuleTreeContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant ModuleTreeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ModuleTreeContext::fields() const
 {
   return p->fields();
@@ -8263,8 +8633,8 @@ class NavPathElemContext::Private
   public:
     Private(const Definition *def) : m_def(def)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("isLinkable",       &Private::isLinkable);
         s_inst.addProperty("fileName",         &Private::fileName);
@@ -8272,13 +8642,16 @@ class NavPathElemContext::Private
         s_inst.addProperty("text",             &Private::text);
         s_inst.addProperty("isReference",      &Private::isReference);
         s_inst.addProperty("externalReference",&Private::externalReference);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -8350,6 +8723,11 @@ TemplateVariant NavPathElemContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant NavPathElemContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector NavPathElemContext::fields() const
 {
   return p->fields();
@@ -8370,8 +8748,8 @@ class ExampleTreeContext::Private
       // Add pages
       ctx->addPages(*Doxygen::exampleLinkedMap,TRUE,visitedClasses);
 
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("tree",          &Private::tree);
         s_inst.addProperty("fileName",      &Private::fileName);
@@ -8381,13 +8759,16 @@ class ExampleTreeContext::Private
         s_inst.addProperty("title",         &Private::title);
         s_inst.addProperty("preferredDepth",&Private::preferredDepth);
         s_inst.addProperty("maxDepth",      &Private::maxDepth);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -8418,6 +8799,7 @@ class ExampleTreeContext::Private
     }
     TemplateVariant maxDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.maxDepthComputed)
       {
         m_cache.maxDepth = computeMaxDepth(m_exampleTree);
@@ -8427,6 +8809,7 @@ class ExampleTreeContext::Private
     }
     TemplateVariant preferredDepth() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.preferredDepthComputed)
       {
         m_cache.preferredDepth = computePreferredDepth(m_exampleTree,maxDepth().toInt());
@@ -8444,6 +8827,7 @@ class ExampleTreeContext::Private
       bool  maxDepthComputed;
       int   preferredDepth;
       bool  preferredDepthComputed;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<ExampleTreeContext::Private> s_inst;
@@ -8465,6 +8849,11 @@ TemplateVariant ExampleTreeContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant ExampleTreeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ExampleTreeContext::fields() const
 {
   return p->fields();
@@ -8479,8 +8868,8 @@ class GlobalsIndexContext::Private
   public:
     Private()
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("all",         &Private::all);
         s_inst.addProperty("functions",   &Private::functions);
@@ -8497,13 +8886,16 @@ class GlobalsIndexContext::Private
         s_inst.addProperty("highlight",   &Private::highlight);
         s_inst.addProperty("subhighlight",&Private::subhighlight);
         s_inst.addProperty("title",       &Private::title);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -8511,6 +8903,7 @@ class GlobalsIndexContext::Private
     typedef bool (MemberDef::*MemberFunc)() const;
     TemplateVariant getMembersFiltered(TemplateListPtr &listRef,MemberFunc filter) const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!listRef) // fill cache
       {
         TemplateListPtr list = TemplateList::alloc();
@@ -8604,6 +8997,7 @@ class GlobalsIndexContext::Private
       TemplateListPtr enums;
       TemplateListPtr enumValues;
       TemplateListPtr macros;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<GlobalsIndexContext::Private> s_inst;
@@ -8625,6 +9019,11 @@ TemplateVariant GlobalsIndexContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant GlobalsIndexContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector GlobalsIndexContext::fields() const
 {
   return p->fields();
@@ -8640,8 +9039,8 @@ class ClassMembersIndexContext::Private
   public:
     Private()
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("all",         &Private::all);
         s_inst.addProperty("functions",   &Private::functions);
@@ -8658,13 +9057,16 @@ class ClassMembersIndexContext::Private
         s_inst.addProperty("highlight",   &Private::highlight);
         s_inst.addProperty("subhighlight",&Private::subhighlight);
         s_inst.addProperty("title",       &Private::title);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -8672,6 +9074,7 @@ class ClassMembersIndexContext::Private
     typedef bool (MemberDef::*MemberFunc)() const;
     TemplateVariant getMembersFiltered(TemplateListPtr &listRef,MemberFunc filter) const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!listRef) // fill cache
       {
         TemplateListPtr list = TemplateList::alloc();
@@ -8767,6 +9170,7 @@ class ClassMembersIndexContext::Private
       TemplateListPtr properties;
       TemplateListPtr events;
       TemplateListPtr related;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<ClassMembersIndexContext::Private> s_inst;
@@ -8788,6 +9192,11 @@ TemplateVariant ClassMembersIndexContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant ClassMembersIndexContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ClassMembersIndexContext::fields() const
 {
   return p->fields();
@@ -8802,8 +9211,8 @@ class NamespaceMembersIndexContext::Private
   public:
     Private()
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("all",         &Private::all);
         s_inst.addProperty("functions",   &Private::functions);
@@ -8820,13 +9229,16 @@ class NamespaceMembersIndexContext::Private
         s_inst.addProperty("highlight",   &Private::highlight);
         s_inst.addProperty("subhighlight",&Private::subhighlight);
         s_inst.addProperty("title",       &Private::title);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -8834,6 +9246,7 @@ class NamespaceMembersIndexContext::Private
     typedef bool (MemberDef::*MemberFunc)() const;
     TemplateVariant getMembersFiltered(TemplateListPtr &listRef,MemberFunc filter) const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!listRef) // fill the cache
       {
         TemplateListPtr list = TemplateList::alloc();
@@ -8926,6 +9339,7 @@ class NamespaceMembersIndexContext::Private
       TemplateListPtr typedefs;
       TemplateListPtr enums;
       TemplateListPtr enumValues;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<NamespaceMembersIndexContext::Private> s_inst;
@@ -8947,6 +9361,11 @@ TemplateVariant NamespaceMembersIndexContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant NamespaceMembersIndexContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector NamespaceMembersIndexContext::fields() const
 {
   return p->fields();
@@ -8961,17 +9380,20 @@ class InheritanceGraphContext::Private
   public:
     Private(DotGfxHierarchyTable *hierarchy,DotNode *n,int id) : m_hierarchy(hierarchy), m_node(n), m_id(id)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("graph",&Private::graph);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -9014,6 +9436,11 @@ TemplateVariant InheritanceGraphContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant InheritanceGraphContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector InheritanceGraphContext::fields() const
 {
   return p->fields();
@@ -9028,24 +9455,28 @@ class InheritanceNodeContext::Private
   public:
     Private(const ClassDef *cd,const QCString &name) : m_classDef(cd), m_name(name)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("class",&Private::getClass);
         s_inst.addProperty("name", &Private::name);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
     }
     TemplateVariant getClass() const
     {
+      std::lock_guard<std::mutex> lock(m_mutex);
       if (!m_classContext)
       {
         m_classContext = ClassContext::alloc(m_classDef);
@@ -9059,6 +9490,7 @@ class InheritanceNodeContext::Private
   private:
     const ClassDef *m_classDef;
     mutable TemplateStructIntfPtr m_classContext;
+    mutable std::mutex m_mutex;
     QCString m_name;
     static PropertyMapper<InheritanceNodeContext::Private> s_inst;
 };
@@ -9079,6 +9511,11 @@ TemplateVariant InheritanceNodeContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant InheritanceNodeContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector InheritanceNodeContext::fields() const
 {
   return p->fields();
@@ -9206,8 +9643,8 @@ class MemberInfoContext::Private
   public:
     Private(const MemberInfo *mi) : m_memberInfo(mi)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         //%% string protection
         s_inst.addProperty("protection",    &Private::protection);
@@ -9217,13 +9654,16 @@ class MemberInfoContext::Private
         s_inst.addProperty("ambiguityScope",&Private::ambiguityScope);
         //%% Member member
         s_inst.addProperty("member",        &Private::member);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -9255,6 +9695,7 @@ class MemberInfoContext::Private
     }
     TemplateVariant member() const
     {
+      std::lock_guard<std::mutex> lock(m_mutex);
       if (!m_member && m_memberInfo->memberDef())
       {
         m_member = MemberContext::alloc(m_memberInfo->memberDef());
@@ -9271,6 +9712,7 @@ class MemberInfoContext::Private
   private:
     const MemberInfo *m_memberInfo;
     mutable TemplateStructIntfPtr m_member;
+    mutable std::mutex m_mutex;
     static PropertyMapper<MemberInfoContext::Private> s_inst;
 };
 //%% }
@@ -9290,6 +9732,11 @@ TemplateVariant MemberInfoContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant MemberInfoContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector MemberInfoContext::fields() const
 {
   return p->fields();
@@ -9362,8 +9809,8 @@ class MemberGroupInfoContext::Private
       m_relPath(relPath),
       m_memberGroup(mg)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("members",      &Private::members);
         s_inst.addProperty("title",        &Private::groupTitle);
@@ -9372,19 +9819,23 @@ class MemberGroupInfoContext::Private
         s_inst.addProperty("memberGroups", &Private::memberGroups);
         s_inst.addProperty("docs",         &Private::docs);
         s_inst.addProperty("inherited",    &Private::inherited);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
     }
     TemplateVariant members() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.memberListContext)
       {
         m_cache.memberListContext = MemberListContext::alloc(&m_memberGroup->members());
@@ -9405,6 +9856,7 @@ class MemberGroupInfoContext::Private
     }
     TemplateVariant memberGroups() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.memberGroups)
       {
         m_cache.memberGroups = MemberGroupListContext::alloc();
@@ -9413,6 +9865,7 @@ class MemberGroupInfoContext::Private
     }
     TemplateVariant docs() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.docs)
       {
         QCString docs = m_memberGroup->documentation();
@@ -9443,6 +9896,7 @@ class MemberGroupInfoContext::Private
       TemplateListIntfPtr              memberListContext;
       TemplateListIntfPtr              memberGroups;
       std::unique_ptr<TemplateVariant> docs;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<MemberGroupInfoContext::Private> s_inst;
@@ -9465,6 +9919,11 @@ TemplateVariant MemberGroupInfoContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant MemberGroupInfoContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector MemberGroupInfoContext::fields() const
 {
   return p->fields();
@@ -9540,8 +9999,8 @@ class MemberListInfoContext::Private
       m_title(title),
       m_subtitle(subtitle)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("members",      &Private::members);
         s_inst.addProperty("title",        &Private::title);
@@ -9549,19 +10008,23 @@ class MemberListInfoContext::Private
         s_inst.addProperty("anchor",       &Private::anchor);
         s_inst.addProperty("memberGroups", &Private::memberGroups);
         s_inst.addProperty("inherited",    &Private::inherited);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
     }
     TemplateVariant members() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.memberListContext)
       {
         m_cache.memberListContext = MemberListContext::alloc(m_memberList);
@@ -9582,6 +10045,7 @@ class MemberListInfoContext::Private
     }
     TemplateVariant memberGroups() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.memberGroups)
       {
         m_cache.memberGroups = MemberGroupListContext::alloc(m_def,m_relPath,m_memberList->getMemberGroupList());
@@ -9590,6 +10054,7 @@ class MemberListInfoContext::Private
     }
     TemplateVariant inherited() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.inherited && (m_memberList->listType()&MemberListType_detailedLists)==0 &&
           m_def->definitionType()==Definition::TypeClass)
       {
@@ -9617,6 +10082,7 @@ class MemberListInfoContext::Private
       TemplateListIntfPtr memberListContext;
       TemplateListIntfPtr memberGroups;
       TemplateListIntfPtr inherited;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<MemberListInfoContext::Private> s_inst;
@@ -9640,6 +10106,11 @@ TemplateVariant MemberListInfoContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant MemberListInfoContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector MemberListInfoContext::fields() const
 {
   return p->fields();
@@ -9655,27 +10126,31 @@ class InheritedMemberInfoContext::Private
     Private(const ClassDef *cd,std::unique_ptr<MemberList> &&ml,const QCString &title)
       : m_class(cd), m_memberList(std::move(ml)), m_title(title)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("class",         &Private::getClass);
         s_inst.addProperty("title",         &Private::title);
         s_inst.addProperty("members",       &Private::members);
         s_inst.addProperty("id",            &Private::id);
         s_inst.addProperty("inheritedFrom", &Private::inheritedFrom);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
     }
     TemplateVariant getClass() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
       if (!m_classCtx)
       {
         m_classCtx = ClassContext::alloc(m_class);
@@ -9688,6 +10163,7 @@ class InheritedMemberInfoContext::Private
     }
     TemplateVariant members() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
       if (!m_memberListCtx)
       {
         m_memberListCtx = MemberListContext::alloc(m_memberList.get());
@@ -9701,6 +10177,7 @@ class InheritedMemberInfoContext::Private
     }
     TemplateVariant inheritedFrom() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
       if (!m_inheritedFrom)
       {
         m_inheritedFrom = TemplateList::alloc();
@@ -9717,6 +10194,7 @@ class InheritedMemberInfoContext::Private
     mutable TemplateStructIntfPtr m_classCtx;
     mutable TemplateListIntfPtr   m_memberListCtx;
     mutable TemplateListPtr m_inheritedFrom;
+    mutable std::recursive_mutex m_mutex;
     static PropertyMapper<InheritedMemberInfoContext::Private> s_inst;
 };
 //%% }
@@ -9737,6 +10215,11 @@ TemplateVariant InheritedMemberInfoContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant InheritedMemberInfoContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector InheritedMemberInfoContext::fields() const
 {
   return p->fields();
@@ -9886,8 +10369,8 @@ class ArgumentContext::Private
     Private(const Argument &arg,const Definition *def,const QCString &relPath) :
       m_argument(arg), m_def(def), m_relPath(relPath)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("type",     &Private::type);
         s_inst.addProperty("name",     &Private::name);
@@ -9896,13 +10379,16 @@ class ArgumentContext::Private
         s_inst.addProperty("attrib",   &Private::attrib);
         s_inst.addProperty("array",    &Private::array);
         s_inst.addProperty("namePart", &Private::namePart);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -9929,6 +10415,7 @@ class ArgumentContext::Private
     }
     TemplateVariant docs() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.docs && m_def)
       {
         if (!m_argument.docs.isEmpty())
@@ -9962,6 +10449,7 @@ class ArgumentContext::Private
     struct Cachable
     {
       std::unique_ptr<TemplateVariant> docs;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<ArgumentContext::Private> s_inst;
@@ -9983,6 +10471,11 @@ TemplateVariant ArgumentContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant ArgumentContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector ArgumentContext::fields() const
 {
   return p->fields();
@@ -10060,20 +10553,23 @@ class SymbolContext::Private
     Private(const Definition *d,const Definition *prev,
             const Definition *next) : m_def(d), m_prevDef(prev), m_nextDef(next)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("fileName",&Private::fileName);
         s_inst.addProperty("anchor",  &Private::anchor);
         s_inst.addProperty("scope",   &Private::scope);
         s_inst.addProperty("relPath", &Private::relPath);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -10201,6 +10697,11 @@ TemplateVariant SymbolContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant SymbolContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector SymbolContext::fields() const
 {
   return p->fields();
@@ -10262,19 +10763,22 @@ class SymbolGroupContext::Private
     Private(const SearchIndexList::const_iterator &start,
             const SearchIndexList::const_iterator &end) : m_start(start), m_end(end)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("id",     &Private::id);
         s_inst.addProperty("name",   &Private::name);
         s_inst.addProperty("symbols",&Private::symbolList);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -10289,6 +10793,7 @@ class SymbolGroupContext::Private
     }
     TemplateVariant symbolList() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.symbolList)
       {
         m_cache.symbolList = SymbolListContext::alloc(m_start,m_end);
@@ -10301,6 +10806,7 @@ class SymbolGroupContext::Private
     struct Cachable
     {
       TemplateListIntfPtr symbolList;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<SymbolGroupContext::Private> s_inst;
@@ -10323,6 +10829,11 @@ TemplateVariant SymbolGroupContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant SymbolGroupContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector SymbolGroupContext::fields() const
 {
   return p->fields();
@@ -10395,19 +10906,22 @@ class SymbolIndexContext::Private
             const SearchIndexList &sl,
             const QCString &name) : m_letter(letter), m_searchList(sl), m_name(name)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("name",        &Private::name);
         s_inst.addProperty("letter",      &Private::letter);
         s_inst.addProperty("symbolGroups",&Private::symbolGroups);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -10422,6 +10936,7 @@ class SymbolIndexContext::Private
     }
     TemplateVariant symbolGroups() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.symbolGroups)
       {
         m_cache.symbolGroups = SymbolGroupListContext::alloc(m_searchList);
@@ -10435,6 +10950,7 @@ class SymbolIndexContext::Private
     struct Cachable
     {
       TemplateListIntfPtr symbolGroups;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<SymbolIndexContext::Private> s_inst;
@@ -10456,6 +10972,11 @@ TemplateVariant SymbolIndexContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant SymbolIndexContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector SymbolIndexContext::fields() const
 {
   return p->fields();
@@ -10510,19 +11031,22 @@ class SearchIndexContext::Private
   public:
     Private(const SearchIndexInfo &info) : m_info(info)
     {
-      static bool init=FALSE;
-      if (!init)
+      static std::once_flag init;
+      std::call_once(init,[]()
       {
         s_inst.addProperty("name",         &Private::name);
         s_inst.addProperty("text",         &Private::text);
         s_inst.addProperty("symbolIndices",&Private::symbolIndices);
-        init=TRUE;
-      }
+      });
     }
     TemplateVariant get(const QCString &n) const
     {
       return s_inst.get(this,n);
     }
+    TemplateVariant lookup(const TemplateKey &key) const
+    {
+      return s_inst.lookup(this,key);
+    }
     StringVector fields() const
     {
       return s_inst.fields();
@@ -10537,6 +11061,7 @@ class SearchIndexContext::Private
     }
     TemplateVariant symbolIndices() const
     {
+      std::lock_guard<std::recursive_mutex> lock(m_cache.mutex);
       if (!m_cache.symbolIndices)
       {
         m_cache.symbolIndices = SymbolIndicesContext::alloc(m_info);
@@ -10548,6 +11073,7 @@ class SearchIndexContext::Private
     struct Cachable
     {
       TemplateListIntfPtr symbolIndices;
+      std::recursive_mutex mutex;
     };
     mutable Cachable m_cache;
     static PropertyMapper<SearchIndexContext::Private> s_inst;
@@ -10569,6 +11095,11 @@ TemplateVariant SearchIndexContext::get(const QCString &name) const
   return p->get(name);
 }
 
+TemplateVariant SearchIndexContext::lookup(const TemplateKey &key) const
+{
+  return p->lookup(key);
+}
+
 StringVector SearchIndexContext::fields() const
 {
   return p->fields();
@@ -10625,6 +11156,10 @@ class HtmlEscaper : public TemplateEscapeIntf
       return convertToHtml(s,TRUE);
     }
     void enableTabbing(bool) {}
+    std::unique_ptr<TemplateEscapeIntf> clone() const
+    {
+      return std::make_unique<HtmlEscaper>(*this);
+    }
 };
 
 //------------------------------------------------------------------------
@@ -10634,6 +11169,10 @@ class LatexSpaceless : public TemplateSpacelessIntf
   public:
     LatexSpaceless() { reset(); }
     void reset() { }
+    std::unique_ptr<TemplateSpacelessIntf> clone() const
+    {
+      return std::make_unique<LatexSpaceless>(*this);
+    }
     QCString remove(const QCString &s)
     {
       if (s.isEmpty()) return s;
@@ -10668,6 +11207,10 @@ class HtmlSpaceless : public TemplateSpacelessIntf
       m_insideString = '\0';
       m_removeSpaces = TRUE;
     }
+    std::unique_ptr<TemplateSpacelessIntf> clone() const
+    {
+      return std::make_unique<HtmlSpaceless>(*this);
+    }
     QCString remove(const QCString &s)
     {
       if (s.isEmpty()) return s;
@@ -10742,6 +11285,10 @@ class LatexEscaper : public TemplateEscapeIntf
       return convertToLaTeX(s,m_tabbing);
     }
     void enableTabbing(bool b) { m_tabbing=b; }
+    std::unique_ptr<TemplateEscapeIntf> clone() const
+    {
+      return std::make_unique<LatexEscaper>(*this);
+    }
   private:
     bool m_tabbing;
 };
@@ -10854,7 +11401,7 @@ void generateOutputViaTemplate()
         if (tpl)
         {
           g_globals.outputFormat = ContextOutputFormat_Html;
-          g_globals.dynSectionId = 0;
+          t_dynSectionId = 0;
           g_globals.outputDir    = Config_getString(HTML_OUTPUT);
           Dir dir(g_globals.outputDir.str());
           createSubDirs(dir);
@@ -10862,6 +11409,8 @@ void generateOutputViaTemplate()
           ctx->setEscapeIntf(Config_getString(HTML_FILE_EXTENSION),&htmlEsc);
           HtmlSpaceless spl;
           ctx->setSpacelessIntf(&spl);
+          DynSectionNumbering numbering;
+          ctx->setPageIntf(&numbering);
           ctx->setOutputDirectory(g_globals.outputDir);
           TextStream ts;
           tpl->render(ts,ctx.get());
@@ -10879,7 +11428,7 @@ void generateOutputViaTemplate()
         if (tpl)
         {
           g_globals.outputFormat = ContextOutputFormat_Latex;
-          g_globals.dynSectionId = 0;
+          t_dynSectionId = 0;
           g_globals.outputDir    = Config_getString(LATEX_OUTPUT);
           Dir dir(g_globals.outputDir.str());
           createSubDirs(dir);
@@ -10887,6 +11436,8 @@ void generateOutputViaTemplate()
           ctx->setEscapeIntf(".tex",&latexEsc);
           LatexSpaceless spl;
           ctx->setSpacelessIntf(&spl);
+          DynSectionNumbering numbering;
+          ctx->setPageIntf(&numbering);
           ctx->setOutputDirectory(g_globals.outputDir);
           TextStream ts;
           tpl->render(ts,ctx.get());
@@ -97,6 +97,7 @@ class DoxygenContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     DoxygenContext();
@@ -117,6 +118,7 @@ class TranslateContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     TranslateContext();
@@ -160,6 +162,7 @@ class IncludeInfoContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     IncludeInfoContext(const IncludeInfo *,SrcLangExt lang);
@@ -201,6 +204,7 @@ class ClassContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ClassContext(const ClassDef *);
@@ -222,6 +226,7 @@ class ConceptContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ConceptContext(const ConceptDef *);
@@ -242,6 +247,7 @@ class NamespaceContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     NamespaceContext(const NamespaceDef *);
@@ -262,6 +268,7 @@ class FileContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     FileContext(const FileDef *);
@@ -281,6 +288,7 @@ class DirContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     DirContext(const DirDef *);
@@ -302,6 +310,7 @@ class PageContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     PageContext(const PageDef *,bool isMainPage,bool isExample);
@@ -322,6 +331,7 @@ class MemberContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     MemberContext(const MemberDef *);
@@ -343,6 +353,7 @@ class ModuleContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ModuleContext(const GroupDef *);
@@ -384,6 +395,7 @@ class ClassIndexContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ClassIndexContext();
@@ -404,6 +416,7 @@ class InheritanceGraphContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     InheritanceGraphContext(DotGfxHierarchyTable *hierarchy,DotNode *n,int id);
@@ -466,6 +479,7 @@ class ClassHierarchyContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ClassHierarchyContext();
@@ -506,6 +520,7 @@ class NestingNodeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     NestingNodeContext(const NestingNodeContext *parent,
@@ -571,6 +586,7 @@ class ClassTreeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ClassTreeContext();
@@ -633,6 +649,7 @@ class NamespaceTreeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     NamespaceTreeContext();
@@ -695,6 +712,7 @@ class FileTreeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     FileTreeContext();
@@ -738,6 +756,7 @@ class PageTreeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     PageTreeContext(const PageLinkedMap &pages);
@@ -802,6 +821,7 @@ class ConceptTreeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ConceptTreeContext();
@@ -822,6 +842,7 @@ class ModuleTreeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ModuleTreeContext();
@@ -864,6 +885,7 @@ class ExampleTreeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ExampleTreeContext();
@@ -884,6 +906,7 @@ class GlobalsIndexContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     GlobalsIndexContext();
@@ -904,6 +927,7 @@ class ClassMembersIndexContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ClassMembersIndexContext();
@@ -924,6 +948,7 @@ class NamespaceMembersIndexContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     NamespaceMembersIndexContext();
@@ -944,6 +969,7 @@ class NavPathElemContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     NavPathElemContext(const Definition *def);
@@ -965,6 +991,7 @@ class InheritanceNodeContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     InheritanceNodeContext(const ClassDef *cd,const QCString &name);
@@ -1033,6 +1060,7 @@ class MemberGroupInfoContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     MemberGroupInfoContext(const Definition *def,const QCString &relPath,const MemberGroup *mg);
@@ -1083,6 +1111,7 @@ class MemberListInfoContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     MemberListInfoContext(const Definition *def,const QCString &relPath,
@@ -1105,6 +1134,7 @@ class MemberInfoContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     MemberInfoContext(const MemberInfo *mi);
@@ -1125,6 +1155,7 @@ class InheritedMemberInfoContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     InheritedMemberInfoContext(const ClassDef *cd,std::unique_ptr<MemberList> &&ml,const QCString &title);
@@ -1188,6 +1219,7 @@ class ArgumentContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     ArgumentContext(const Argument &arg,const Definition *def,const QCString &relPath);
@@ -1232,6 +1264,7 @@ class SymbolContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     SymbolContext(const Definition *def,const Definition *prev,const Definition *next);
@@ -1276,6 +1309,7 @@ class SymbolGroupContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     SymbolGroupContext(const SearchIndexList::const_iterator &start,
@@ -1319,6 +1353,7 @@ class SymbolIndexContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     SymbolIndexContext(const std::string &letter,const SearchIndexList &sl,const QCString &name);
@@ -1360,6 +1395,7 @@ class SearchIndexContext : public TemplateStructIntf
 
     // TemplateStructIntf methods
     virtual TemplateVariant get(const QCString &name) const;
+    virtual TemplateVariant lookup(const TemplateKey &key) const;
     virtual StringVector fields() const;
 
     SearchIndexContext(const SearchIndexInfo &info);
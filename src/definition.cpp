@@ -575,135 +575,6 @@ void DefinitionImpl::setInbodyDocumentation(const QCString &d,const QCString &in
   _setInbodyDocumentation(d,inbodyFile,inbodyLine);
 }
 
-//---------------------------------------
-
-struct FilterCacheItem
-{
-  portable_off_t filePos;
-  size_t fileSize;
-};
-
-/*! Cache for storing the result of filtering a file */
-class FilterCache
-{
-  public:
-    FilterCache() : m_endPos(0) { }
-    bool getFileContents(const QCString &fileName,BufStr &str)
-    {
-      static bool filterSourceFiles = Config_getBool(FILTER_SOURCE_FILES);
-      QCString filter = getFileFilter(fileName,TRUE);
-      bool usePipe = !filter.isEmpty() && filterSourceFiles;
-      FILE *f=0;
-      const int blockSize = 4096;
-      char buf[blockSize];
-      auto it = m_cache.find(fileName.str());
-      if (usePipe && it!=m_cache.end()) // cache hit: reuse stored result
-      {
-        auto item = it->second;
-        //printf("getFileContents(%s): cache hit\n",qPrint(fileName));
-        // file already processed, get the results after filtering from the tmp file
-        Debug::print(Debug::FilterOutput,0,"Reusing filter result for %s from %s at offset=%d size=%d\n",
-               qPrint(fileName),qPrint(Doxygen::filterDBFileName),(int)item.filePos,(int)item.fileSize);
-        f = Portable::fopen(Doxygen::filterDBFileName,"rb");
-        if (f)
-        {
-          bool success=TRUE;
-          str.resize(static_cast<uint>(item.fileSize+1));
-          if (Portable::fseek(f,item.filePos,SEEK_SET)==-1)
-          {
-            err("Failed to seek to position %d in filter database file %s\n",(int)item.filePos,qPrint(Doxygen::filterDBFileName));
-            success=FALSE;
-          }
-          if (success)
-          {
-            size_t numBytes = fread(str.data(),1,item.fileSize,f);
-            if (numBytes!=item.fileSize)
-            {
-              err("Failed to read %d bytes from position %d in filter database file %s: got %d bytes\n",
-                 (int)item.fileSize,(int)item.filePos,qPrint(Doxygen::filterDBFileName),(int)numBytes);
-              success=FALSE;
-            }
-          }
-          str.addChar('\0');
-          fclose(f);
-          return success;
-        }
-        else
-        {
-          err("Failed to open filter database file %s\n",qPrint(Doxygen::filterDBFileName));
-          return FALSE;
-        }
-      }
-      else if (usePipe) // cache miss: filter active but file not previously processed
-      {
-        //printf("getFileContents(%s): cache miss\n",qPrint(fileName));
-        // filter file
-        QCString cmd=filter+" \""+fileName+"\"";
-        Debug::print(Debug::ExtCmd,0,"Executing popen(`%s`)\n",qPrint(cmd));
-        f = Portable::popen(cmd,"r");
-        FILE *bf = Portable::fopen(Doxygen::filterDBFileName,"a+b");
-        FilterCacheItem item;
-        item.filePos = m_endPos;
-        if (bf==0)
-        {
-          // handle error
-          err("Error opening filter database file %s\n",qPrint(Doxygen::filterDBFileName));
-          str.addChar('\0');
-          Portable::pclose(f);
-          return FALSE;
-        }
-        // append the filtered output to the database file
-        size_t size=0;
-        while (!feof(f))
-        {
-          size_t bytesRead = fread(buf,1,blockSize,f);
-          size_t bytesWritten = fwrite(buf,1,bytesRead,bf);
-          if (bytesRead!=bytesWritten)
-          {
-            // handle error
-            err("Failed to write to filter database %s. Wrote %d out of %d bytes\n",
-                qPrint(Doxygen::filterDBFileName),(int)bytesWritten,(int)bytesRead);
-            str.addChar('\0');
-            Portable::pclose(f);
-            fclose(bf);
-            return FALSE;
-          }
-          size+=bytesWritten;
-          str.addArray(buf,static_cast<uint>(bytesWritten));
-        }
-        str.addChar('\0');
-        item.fileSize = size;
-        // add location entry to the dictionary
-        m_cache.insert(std::make_pair(fileName.str(),item));
-        Debug::print(Debug::FilterOutput,0,"Storing new filter result for %s in %s at offset=%d size=%d\n",
-               qPrint(fileName),qPrint(Doxygen::filterDBFileName),(int)item.filePos,(int)item.fileSize);
-        // update end of file position
-        m_endPos += size;
-        Portable::pclose(f);
-        fclose(bf);
-      }
-      else // no filtering
-      {
-        // normal file
-        //printf("getFileContents(%s): no filter\n",qPrint(fileName));
-        f = Portable::fopen(fileName,"r");
-        while (!feof(f))
-        {
-          size_t bytesRead = fread(buf,1,blockSize,f);
-          str.addArray(buf,static_cast<uint>(bytesRead));
-        }
-        str.addChar('\0');
-        fclose(f);
-      }
-      return TRUE;
-    }
-  private:
-    std::unordered_map<std::string,FilterCacheItem> m_cache;
-    portable_off_t m_endPos;
-};
-
-static FilterCache g_filterCache;
-
 //-----------------------------------------
 
 
@@ -729,7 +600,8 @@ bool readCodeFragment(const QCString &fileName,
   SrcLangExt lang = getLanguageFromFileName(fileName);
   const int blockSize = 4096;
   BufStr str(blockSize);
-  g_filterCache.getFileContents(fileName,str);
+  // the file contents are shared with the parser and the source browser via the input file cache
+  if (!readInputFile(fileName,str,filterSourceFiles,TRUE)) return FALSE;
 
   bool found = lang==SrcLangExt_VHDL   ||
                lang==SrcLangExt_Python ||
@@ -852,7 +724,6 @@ bool readCodeFragment(const QCString &fileName,
       Debug::print(Debug::FilterOutput,0,"-------------\n%s\n-------------\n",qPrint(result));
     }
   }
-  result = transcodeCharacterStringToUTF8(result);
   if (!result.isEmpty() && result.at(result.length()-1)!='\n') result += "\n";
   //printf("readCodeFragment(%d-%d)=%s\n",startLine,endLine,qPrint(result));
   return found;
@@ -260,6 +260,14 @@ bool Dir::remove(const std::string &path,bool acceptsAbsPath) const
   return fs::remove(result,ec);
 }
 
+bool Dir::touch(const std::string &path,bool acceptsAbsPath) const
+{
+  std::error_code ec;
+  std::string result = filePath(path,acceptsAbsPath);
+  fs::last_write_time(result,fs::file_time_type::clock::now(),ec);
+  return !ec;
+}
+
 bool Dir::rename(const std::string &orgName,const std::string &newName,bool acceptsAbsPath) const
 {
   std::error_code ec;
@@ -279,6 +287,16 @@ bool Dir::copy(const std::string &srcName,const std::string &dstName,bool accept
   return !ec;
 }
 
+bool Dir::link(const std::string &srcName,const std::string &dstName,bool acceptsAbsPath) const
+{
+  std::error_code ec;
+  std::string sn = filePath(srcName,acceptsAbsPath);
+  std::string dn = filePath(dstName,acceptsAbsPath);
+  fs::remove(dn,ec);
+  fs::create_hard_link(sn,dn,ec);
+  return !ec;
+}
+
 std::string Dir::currentDirPath()
 {
   std::error_code ec;
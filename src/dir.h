@@ -88,6 +88,9 @@ class Dir final
     bool rename(const std::string &orgName,const std::string &newName,
                 bool acceptsAbsPath=true) const;
     bool copy(const std::string &src,const std::string &dest,bool acceptsAbsPath=true) const;
+    bool link(const std::string &src,const std::string &dest,bool acceptsAbsPath=true) const;
+    /** Sets the modification time of \a path to the current time. */
+    bool touch(const std::string &path,bool acceptsAbsPath=true) const;
     std::string absPath() const;
 
     bool isRelative() const;
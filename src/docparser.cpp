@@ -51,6 +51,7 @@
 #include "emoji.h"
 #include "fileinfo.h"
 #include "dir.h"
+#include "profiler.h"
 
 #define TK_COMMAND_CHAR(token) ((token)==TK_COMMAND_AT ? "@" : "\\")
 
@@ -1784,7 +1785,7 @@ void DocParser::readTextFileByName(const QCString &file,QCString &text)
     FileInfo fi(file.str());
     if (fi.exists())
     {
-      text = fileToString(file,Config_getBool(FILTER_SOURCE_FILES));
+      text = fileToString(file,Config_getBool(FILTER_SOURCE_FILES),FALSE,TRUE); // example files are input, so they are cached
       return;
     }
   }
@@ -1795,7 +1796,7 @@ void DocParser::readTextFileByName(const QCString &file,QCString &text)
     FileInfo fi(absFileName);
     if (fi.exists())
     {
-      text = fileToString(QCString(absFileName),Config_getBool(FILTER_SOURCE_FILES));
+      text = fileToString(QCString(absFileName),Config_getBool(FILTER_SOURCE_FILES),FALSE,TRUE);
       return;
     }
   }
@@ -1805,7 +1806,7 @@ void DocParser::readTextFileByName(const QCString &file,QCString &text)
   FileDef *fd = findFileDef(Doxygen::exampleNameLinkedMap,file,ambig);
   if (fd)
   {
-    text = fileToString(fd->absFilePath(),Config_getBool(FILTER_SOURCE_FILES));
+    text = fileToString(fd->absFilePath(),Config_getBool(FILTER_SOURCE_FILES),FALSE,TRUE);
     if (ambig)
     {
       warn_doc_error(context.fileName,tokenizer.getLineNr(),"included file name %s is ambiguous"
@@ -7494,6 +7495,7 @@ DocRoot *validatingParseDoc(IDocParser &parserIntf,
                             bool singleLine, bool linkFromIndex,
                             bool markdownSupport)
 {
+  ProfileScope profile("parse doc",fileName);
   DocParser &parser = dynamic_cast<DocParser&>(parserIntf);
   //printf("validatingParseDoc(%s,%s)=[%s]\n",ctx?qPrint(ctx->name()):"<none>",
   //                                     md?qPrint(md->name()):"<none>",
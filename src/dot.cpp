@@ -17,6 +17,7 @@
 #include <cassert>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 
 #include "config.h"
 #include "dot.h"
@@ -29,6 +30,9 @@
 #include "language.h"
 #include "index.h"
 #include "dir.h"
+#include "fileinfo.h"
+#include "scheduler.h"
+#include "dotcache.h"
 
 #define MAP_CMD "cmapx"
 
@@ -73,9 +77,11 @@ static void unsetDotFontPath()
 //--------------------------------------------------------------------
 
 DotManager *DotManager::m_theInstance = 0;
+static std::mutex g_instanceMutex;
 
 DotManager *DotManager::instance()
 {
+  std::lock_guard<std::mutex> lock(g_instanceMutex);
   if (!m_theInstance)
   {
     m_theInstance = new DotManager;
@@ -85,6 +91,7 @@ DotManager *DotManager::instance()
 
 void DotManager::deleteInstance()
 {
+  std::lock_guard<std::mutex> lock(g_instanceMutex);
   delete m_theInstance;
   m_theInstance=0;
 }
@@ -92,8 +99,8 @@ void DotManager::deleteInstance()
 DotManager::DotManager() : m_runners(), m_filePatchers()
 {
   m_queue = new DotRunnerQueue;
-  int i;
-  int dotNumThreads = Config_getInt(DOT_NUM_THREADS);
+  size_t i;
+  size_t dotNumThreads = Scheduler::instance().numDotThreads();
   if (dotNumThreads!=1)
   {
     for (i=0;i<dotNumThreads;i++)
@@ -119,6 +126,7 @@ DotManager::~DotManager()
 
 DotRunner* DotManager::createRunner(const QCString &absDotName, const QCString& md5Hash)
 {
+  std::lock_guard<std::mutex> lock(m_mutex); // pages with graphs can be written in parallel
   DotRunner* rv = nullptr;
   auto const runit = m_runners.find(absDotName.str());
   if (runit == m_runners.end())
@@ -142,19 +150,61 @@ DotRunner* DotManager::createRunner(const QCString &absDotName, const QCString&
 
 DotFilePatcher *DotManager::createFilePatcher(const QCString &fileName)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   auto patcher = m_filePatchers.find(fileName.str());
 
-  if (patcher != m_filePatchers.end()) return &(patcher->second);
+  if (patcher != m_filePatchers.end()) return patcher->second.get();
 
-  auto rv = m_filePatchers.emplace(std::make_pair(fileName.str(), fileName));
+  auto rv = m_filePatchers.emplace(fileName.str(), std::make_unique<DotFilePatcher>(fileName));
   assert(rv.second);
-  return &(rv.first->second);
+  return rv.first->second.get();
+}
+
+std::vector<DotRunner*> DotManager::batchRunners() const
+{
+  // Starting dot takes more time than rendering a typical small include or call graph,
+  // so graphs that are rendered to the same formats are combined into a single dot run.
+  // Batches are kept small enough to keep all threads busy, and graphs are added
+  // until the combined size of the dot files would become too large.
+  const size_t maxBatchBytes  = 64*1024;
+  const size_t maxBatchGraphs = 64;
+  const size_t numThreads = std::max<size_t>(m_workers.size(),1);
+  const size_t batchGraphs = std::max<size_t>(1,std::min(maxBatchGraphs,m_runners.size()/(numThreads*4)));
+
+  std::vector<DotRunner*> result;
+  std::map<std::string,DotRunner*> openBatches; // batch being filled for each batch key
+  for (const auto &dr : m_runners)
+  {
+    DotRunner *runner = dr.second.get();
+    std::string key = batchGraphs>1 ? runner->batchKey() : std::string();
+    if (!key.empty())
+    {
+      auto it = openBatches.find(key);
+      if (it!=openBatches.end())
+      {
+        DotRunner *batch = it->second;
+        size_t bytes = FileInfo(dr.first).size();
+        if (batch->batchSize()<batchGraphs && batch->batchBytes()+bytes<=maxBatchBytes)
+        {
+          batch->addToBatch(runner);
+          continue;
+        }
+      }
+      openBatches[key] = runner; // start a new batch
+    }
+    result.push_back(runner);
+  }
+  return result;
 }
 
 bool DotManager::run() const
 {
   size_t numDotRuns = m_runners.size();
   size_t numFilePatchers = m_filePatchers.size();
+  if (DotCache::instance().numHits()>0)
+  {
+    msg("Reused %d images from the dot cache\n",DotCache::instance().numHits());
+  }
   if (numDotRuns+numFilePatchers>1)
   {
     if (m_workers.size()==0)
@@ -190,22 +240,28 @@ bool DotManager::run() const
     setPath=TRUE;
   }
   Portable::sysTimerStart();
+  std::vector<DotRunner*> runners = batchRunners();
+  numDotRuns = runners.size();
   // fill work queue with dot operations
   size_t prev=1;
   if (m_workers.size()==0) // no threads to work with
   {
-    for (auto & dr : m_runners)
+    for (auto & dr : runners)
     {
       msg("Running dot for graph %zu/%zu\n",prev,numDotRuns);
-      dr.second->run();
+      auto startTime = std::chrono::steady_clock::now();
+      dr->run();
+      auto endTime = std::chrono::steady_clock::now();
+      Scheduler::instance().addDotBusyTime(std::chrono::duration_cast<
+          std::chrono::microseconds>(endTime - startTime).count()/1000000.0);
       prev++;
     }
   }
   else // use multiple threads to run instances of dot in parallel
   {
-    for (auto & dr: m_runners)
+    for (auto & dr: runners)
     {
-      m_queue->enqueue(dr.second.get());
+      m_queue->enqueue(dr);
     }
     // wait for the queue to become empty
     while ((i=m_queue->size())>0)
@@ -248,19 +304,19 @@ bool DotManager::run() const
   // then the other files.
   for (auto & fp : m_filePatchers)
   {
-    if (fp.second.isSVGFile())
+    if (fp.second->isSVGFile())
     {
       msg("Patching output file %zu/%zu\n",i,numFilePatchers);
-      if (!fp.second.run()) return FALSE;
+      if (!fp.second->run()) return FALSE;
       i++;
     }
   }
   for (auto& fp : m_filePatchers)
   {
-    if (!fp.second.isSVGFile())
+    if (!fp.second->isSVGFile())
     {
       msg("Patching output file %zu/%zu\n",i,numFilePatchers);
-      if (!fp.second.run()) return FALSE;
+      if (!fp.second->run()) return FALSE;
       i++;
     }
   }
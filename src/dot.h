@@ -17,6 +17,7 @@
 #define DOT_H
 
 #include <map>
+#include <mutex>
 
 #include "qcstring.h"
 #include "dotgraph.h" // only for GraphOutputFormat
@@ -38,11 +39,14 @@ class DotManager
     bool run() const;
 
   private:
+    std::vector<DotRunner*> batchRunners() const;
+
     DotManager();
     virtual ~DotManager();
 
     std::map<std::string, std::unique_ptr<DotRunner>>       m_runners;
-    std::map<std::string, DotFilePatcher>  m_filePatchers;
+    std::map<std::string, std::unique_ptr<DotFilePatcher>>  m_filePatchers;
+    std::mutex             m_mutex; // guards m_runners and m_filePatchers
     static DotManager     *m_theInstance;
     DotRunnerQueue        *m_queue;
     std::vector< std::unique_ptr<DotWorkerThread> > m_workers;
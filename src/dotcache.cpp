@@ -0,0 +1,158 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "dotcache.h"
+#include "config.h"
+#include "dir.h"
+#include "fileinfo.h"
+#include "md5.h"
+#include "message.h"
+#include "portable.h"
+
+struct DotCache::Private
+{
+  std::once_flag initFlag;
+  bool enabled = false;
+  QCString dirName;
+  QCString fingerprint;
+  std::atomic<int> hits { 0 };
+
+  void initialize();
+  QCString fileName(const QCString &md5,const QCString &format) const;
+};
+
+/** Returns the version banner of the dot tool, so images made by different
+ *  versions of graphviz are kept apart.
+ */
+static QCString dotVersion()
+{
+  QCString result;
+  QCString cmd = "\""+Config_getString(DOT_PATH)+"dot\" -V 2>&1";
+  FILE *f = Portable::popen(cmd,"r");
+  if (f)
+  {
+    char buf[256];
+    while (fgets(buf,sizeof(buf),f))
+    {
+      result+=buf;
+    }
+    Portable::pclose(f);
+  }
+  return result.stripWhiteSpace();
+}
+
+void DotCache::Private::initialize()
+{
+  QCString dir = Config_getString(DOT_CACHE_DIR);
+  if (dir.isEmpty()) return;
+  if (Dir::isRelativePath(dir.str()))
+  {
+    dir.prepend(Config_getString(OUTPUT_DIRECTORY)+"/");
+  }
+  Dir d(dir.str());
+  if (!d.exists() && !d.mkdir(dir.str()))
+  {
+    warn_uncond("Could not create dot cache directory %s, dot cache is disabled\n",qPrint(dir));
+    return;
+  }
+  dirName = d.absPath();
+  fingerprint = dotVersion()+"\n"+Config_getString(DOT_FONTPATH)+"\n";
+  enabled = true;
+}
+
+QCString DotCache::Private::fileName(const QCString &md5,const QCString &format) const
+{
+  QCString key = fingerprint+md5+"\n"+format;
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Buffer(reinterpret_cast<const unsigned char *>(key.data()),key.length(),md5_sig);
+  MD5SigToString(md5_sig,sigStr);
+  // strip the renderer part of formats like png:cairo:gd for the extension
+  int i = format.find(':');
+  QCString ext = i==-1 ? format : format.left(i);
+  // spread the files over subdirectories to keep directory sizes reasonable
+  return dirName+"/"+QCString(sigStr).left(2)+"/"+sigStr+"."+ext;
+}
+
+DotCache::DotCache() : p(std::make_unique<Private>())
+{
+}
+
+DotCache::~DotCache()
+{
+}
+
+DotCache &DotCache::instance()
+{
+  static DotCache cache;
+  return cache;
+}
+
+bool DotCache::isEnabled() const
+{
+  std::call_once(p->initFlag,[this]() { p->initialize(); });
+  return p->enabled;
+}
+
+bool DotCache::fetch(const QCString &md5,const QCString &format,const QCString &output)
+{
+  if (!isEnabled() || md5.isEmpty()) return false;
+  QCString cacheName = p->fileName(md5,format);
+  FileInfo fi(cacheName.str());
+  if (!fi.exists() || fi.size()==0) return false;
+  Dir dir;
+  // Hard linking is safe since doxygen never modifies the output files in place:
+  // patching replaces the file and dot is only run after removing old output.
+  if (!dir.link(cacheName.str(),output.str()) && !dir.copy(cacheName.str(),output.str()))
+  {
+    return false;
+  }
+  p->hits++;
+  return true;
+}
+
+int DotCache::numHits() const
+{
+  return p->hits;
+}
+
+void DotCache::store(const QCString &md5,const QCString &format,const QCString &output)
+{
+  if (!isEnabled() || md5.isEmpty()) return;
+  QCString cacheName = p->fileName(md5,format);
+  Dir dir;
+  if (dir.exists(cacheName.str())) return; // stored by another run already
+  std::string subDir = FileInfo(cacheName.str()).dirPath();
+  if (!dir.exists(subDir) && !dir.mkdir(subDir) && !dir.exists(subDir))
+  {
+    return;
+  }
+  // add the file under a temporary name first, so other processes sharing
+  // the cache never see a partially written file.
+  std::ostringstream tmpSuffix;
+  tmpSuffix << ".tmp" << Portable::pid() << "_" << std::this_thread::get_id();
+  std::string tmpName = cacheName.str()+tmpSuffix.str();
+  if ((dir.link(output.str(),tmpName) || dir.copy(output.str(),tmpName)) &&
+      dir.rename(tmpName,cacheName.str()))
+  {
+    return;
+  }
+  dir.remove(tmpName);
+}
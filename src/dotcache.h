@@ -0,0 +1,64 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef DOTCACHE_H
+#define DOTCACHE_H
+
+#include <memory>
+
+#include "qcstring.h"
+
+/** @brief Persistent cache of the images and maps produced by dot.
+ *
+ *  Rendered output is stored in the directory set with \c DOT_CACHE_DIR
+ *  under a name derived from the MD5 digest of the graph, the output
+ *  format, and the version of dot. Since the name only depends on the
+ *  contents, the directory can be shared between projects, branches, and
+ *  build jobs. Cached files are hard linked (or copied if that is not
+ *  possible) to their location in the output directory instead of running dot.
+ *
+ *  All methods can be called from multiple threads.
+ */
+class DotCache
+{
+  public:
+    static DotCache &instance();
+
+    /** Returns TRUE if a cache directory is configured. */
+    bool isEnabled() const;
+
+    /** Places the cached output for the graph with digest \a md5 in format
+     *  \a format at \a output. Returns FALSE if the output is not cached.
+     */
+    bool fetch(const QCString &md5,const QCString &format,const QCString &output);
+
+    /** Adds the file \a output, which dot produced in format \a format for the
+     *  graph with digest \a md5, to the cache.
+     */
+    void store(const QCString &md5,const QCString &format,const QCString &output);
+
+    /** Returns the number of files that were taken from the cache. */
+    int numHits() const;
+
+  private:
+    DotCache();
+   ~DotCache();
+    DotCache(const DotCache &) = delete;
+    DotCache &operator=(const DotCache &) = delete;
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -258,6 +258,7 @@ bool DotFilePatcher::isSVGFile() const
 int DotFilePatcher::addMap(const QCString &mapFile,const QCString &relPath,
                            bool urlOnly,const QCString &context,const QCString &label)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   int id = (int)m_maps.size();
   m_maps.emplace_back(mapFile,relPath,urlOnly,context,label);
   return id;
@@ -266,6 +267,7 @@ int DotFilePatcher::addMap(const QCString &mapFile,const QCString &relPath,
 int DotFilePatcher::addFigure(const QCString &baseName,
                               const QCString &figureName,bool heightCheck)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   int id = (int)m_maps.size();
   m_maps.emplace_back(figureName,"",heightCheck,"",baseName);
   return id;
@@ -275,6 +277,7 @@ int DotFilePatcher::addSVGConversion(const QCString &relPath,bool urlOnly,
                                      const QCString &context,bool zoomable,
                                      int graphId)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   int id = (int)m_maps.size();
   m_maps.emplace_back("",relPath,urlOnly,context,"",zoomable,graphId);
   return id;
@@ -284,6 +287,7 @@ int DotFilePatcher::addSVGObject(const QCString &baseName,
                                  const QCString &absImgName,
                                  const QCString &relPath)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   int id = (int)m_maps.size();
   m_maps.emplace_back(absImgName,relPath,false,"",baseName);
   return id;
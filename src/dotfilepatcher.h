@@ -17,12 +17,15 @@
 #define DOTFILEPATCHER_H
 
 #include <vector>
+#include <mutex>
 
 #include "qcstring.h"
 
 class TextStream;
 
-/** Helper class to insert a set of map file into an output file */
+/** Helper class to insert a set of map file into an output file.
+ *  The add methods can be called from multiple threads.
+ */
 class DotFilePatcher
 {
   public:
@@ -68,6 +71,7 @@ class DotFilePatcher
     };
     std::vector<Map> m_maps;
     QCString m_patchFile;
+    std::mutex m_mutex;
 };
 
 
@@ -14,6 +14,7 @@
 */
 
 #include <sstream>
+#include <mutex>
 
 #include "config.h"
 #include "doxygen.h"
@@ -24,6 +25,7 @@
 
 #include "dot.h"
 #include "dotrunner.h"
+#include "dotcache.h"
 #include "dotgraph.h"
 #include "dotnode.h"
 #include "dotfilepatcher.h"
@@ -31,6 +33,8 @@
 
 #define MAP_CMD "cmapx"
 
+static std::mutex g_indexMutex; // pages with graphs can be written in parallel
+
 //QCString DotGraph::DOT_FONTNAME; // will be initialized in initDot
 //int DotGraph::DOT_FONTSIZE;      // will be initialized in initDot
 
@@ -133,7 +137,11 @@ QCString DotGraph::writeGraph(
 
   m_regenerate = prepareDotFile();
 
-  if (!m_doNotAddImageToIndex) Doxygen::indexList->addImageFile(imgName());
+  if (!m_doNotAddImageToIndex)
+  {
+    std::lock_guard<std::mutex> lock(g_indexMutex);
+    Doxygen::indexList->addImageFile(imgName());
+  }
 
   generateCode(t);
 
@@ -166,19 +174,32 @@ bool DotGraph::prepareDotFile()
     return FALSE;
   }
 
-  // need to rebuild the image
+  // need to rebuild the image, see if we rendered the same graph before
+  bool cached = fetchFromDotCache(sigStr);
 
-  // write .dot file because image was new or has changed
-  std::ofstream f(absDotName().str(),std::ofstream::out | std::ofstream::binary);
-  if (!f.is_open())
+  if (!cached || !Config_getBool(DOT_CLEANUP))
   {
-    err("Could not open file %s for writing\n",qPrint(absDotName()));
-    return TRUE;
+    // write .dot file because image was new or has changed
+    std::ofstream f(absDotName().str(),std::ofstream::out | std::ofstream::binary);
+    if (!f.is_open())
+    {
+      err("Could not open file %s for writing\n",qPrint(absDotName()));
+      return TRUE;
+    }
+    f << m_theGraph;
+    f.close();
   }
-  f << m_theGraph;
-  f.close();
 
-  if (m_graphFormat == GOF_BITMAP)
+  if (cached)
+  {
+    // create checksum file, as would have been done after running dot
+    std::ofstream f(absBaseName().str()+".md5",std::ofstream::out | std::ofstream::binary);
+    if (f.is_open())
+    {
+      f << sigStr;
+    }
+  }
+  else if (m_graphFormat == GOF_BITMAP)
   {
     // run dot to create a bitmap image
     DotRunner * dotRun = DotManager::instance()->createRunner(absDotName(), sigStr);
@@ -201,6 +222,22 @@ bool DotGraph::prepareDotFile()
   return TRUE;
 }
 
+bool DotGraph::fetchFromDotCache(const QCString &md5) const
+{
+  DotCache &cache = DotCache::instance();
+  if (!cache.isEnabled()) return false;
+  if (m_graphFormat == GOF_BITMAP)
+  {
+    return cache.fetch(md5,Config_getEnumAsString(DOT_IMAGE_FORMAT),absImgName()) &&
+           (!m_generateImageMap || cache.fetch(md5,MAP_CMD,absMapName()));
+  }
+  else if (m_graphFormat == GOF_EPS)
+  {
+    return cache.fetch(md5,Config_getBool(USE_PDFLATEX) ? "pdf" : "ps",absImgName());
+  }
+  return false;
+}
+
 void DotGraph::generateCode(TextStream &t)
 {
   QCString imgExt = getDotImageExtension();
@@ -98,6 +98,7 @@ class DotGraph
     DotGraph &operator=(const DotGraph &);
 
     bool prepareDotFile();
+    bool fetchFromDotCache(const QCString &md5) const;
     void generateCode(TextStream &t);
 
     int m_curNodeNumber = 0;
@@ -14,6 +14,7 @@
 */
 
 #include <cassert>
+#include <chrono>
 
 #include "dotrunner.h"
 #include "util.h"
@@ -22,6 +23,15 @@
 #include "message.h"
 #include "config.h"
 #include "dir.h"
+#include "fileinfo.h"
+#include "scheduler.h"
+#include "dotcache.h"
+#include "profiler.h"
+#include "settings.h"
+
+#if USE_LIBGVC
+#include <gvc.h>
+#endif
 
 // the graphicx LaTeX has a limitation of maximum size of 16384
 // To be on the save side we take it a little bit smaller i.e. 150 inch * 72 dpi
@@ -138,6 +148,45 @@ bool DotRunner::readBoundingBox(const QCString &fileName,int *width,int *height,
 
 //---------------------------------------------------------------------------------
 
+#if USE_LIBGVC
+/** Graphviz keeps global state while laying out and rendering a graph,
+ *  so only one thread at a time can use the in-process renderer.
+ */
+static std::mutex g_gvcMutex;
+static GVC_t     *g_gvc = nullptr;
+
+/** Tries to lay out the graph in \a dotFile once and render it for all \a jobs
+ *  using the graphviz libraries. Returns FALSE if the renderer is busy
+ *  or rendering failed, in which case the dot tool should be used instead.
+ */
+template<class Jobs>
+static bool runInProcess(const QCString &dotFile,const Jobs &jobs)
+{
+  std::unique_lock<std::mutex> lock(g_gvcMutex,std::try_to_lock);
+  if (!lock.owns_lock()) return FALSE; // in use by another thread
+  if (!g_gvc)
+  {
+    g_gvc = gvContext();
+    if (!g_gvc) return FALSE;
+  }
+  FILE *f = Portable::fopen(dotFile,"r");
+  if (!f) return FALSE;
+  Agraph_t *g = agread(f,nullptr);
+  fclose(f);
+  if (!g) return FALSE;
+  bool ok = gvLayout(g_gvc,g,"dot")==0;
+  for (auto it = jobs.begin(); ok && it!=jobs.end(); ++it)
+  {
+    ok = gvRenderFilename(g_gvc,g,it->format.data(),it->output.data())==0;
+  }
+  gvFreeLayout(g_gvc,g);
+  agclose(g);
+  return ok;
+}
+#endif
+
+//---------------------------------------------------------------------------------
+
 DotRunner::DotRunner(const QCString& absDotName, const QCString& md5Hash)
   : m_file(absDotName)
   , m_md5Hash(md5Hash)
@@ -150,7 +199,7 @@ DotRunner::DotRunner(const QCString& absDotName, const QCString& md5Hash)
 void DotRunner::addJob(const QCString &format, const QCString &output,
                       const QCString &srcFile,int srcLine)
 {
-
+  std::lock_guard<std::mutex> lock(m_jobsMutex);
   for (auto& s: m_jobs)
   {
     if (s.format != format) continue;
@@ -170,6 +219,90 @@ QCString getBaseNameOfOutput(const QCString &output)
 }
 
 bool DotRunner::run()
+{
+  ProfileScope profile("run dot",m_file);
+  return m_batch.empty() ? runSingle() : runBatch();
+}
+
+std::string DotRunner::batchKey() const
+{
+#if USE_LIBGVC
+  if (Config_getBool(DOT_IN_PROCESS)) return std::string(); // rendered in-process
+#endif
+  // rendering multiple formats in one invocation needs a recent dot
+  if (m_jobs.empty() || (m_jobs.size()>1 && !Config_getBool(DOT_MULTI_TARGETS))) return std::string();
+  std::string key;
+  for (const auto &s : m_jobs)
+  {
+    // pdf output may need to be regenerated after checking its size, and dot names the output
+    // for formats with a renderer (like png:cairo) differently, so these are done separately.
+    if (s.format.left(3)=="pdf" || s.format.find(':')!=-1) return std::string();
+    key+=s.format.str()+" ";
+  }
+  return key;
+}
+
+void DotRunner::addToBatch(DotRunner *runner)
+{
+  if (m_batch.empty()) m_batchBytes = FileInfo(m_file.str()).size();
+  m_batch.push_back(runner);
+  m_batchBytes += FileInfo(runner->m_file.str()).size();
+}
+
+bool DotRunner::runBatch()
+{
+  // all graphs are rendered to the same formats, see batchKey(). With -O dot writes
+  // the output of input file <name> in format <fmt> to <name>.<fmt>
+  QCString dotArgs;
+  for (const auto &s : m_jobs)
+  {
+    dotArgs+="-T"+s.format+" ";
+  }
+  dotArgs+="-O \""+m_file+"\"";
+  for (const auto &runner : m_batch)
+  {
+    dotArgs+=" \""+runner->m_file+"\"";
+  }
+  if (Portable::system(m_dotExe,dotArgs,FALSE)!=0)
+  {
+    // run dot for each graph on its own, so problems are reported for the right graph
+    bool ok = runSingle();
+    for (const auto &runner : m_batch)
+    {
+      ok = runner->runSingle() && ok;
+    }
+    return ok;
+  }
+  bool ok = collectBatchOutput();
+  for (const auto &runner : m_batch)
+  {
+    ok = runner->collectBatchOutput() && ok;
+  }
+  return ok;
+}
+
+bool DotRunner::collectBatchOutput()
+{
+  Dir thisDir;
+  bool ok = TRUE;
+  for (auto& s : m_jobs)
+  {
+    QCString dotOutput = m_file+"."+s.format;
+    if (!thisDir.rename(dotOutput.str(),s.output.str()))
+    {
+      err_full(s.srcFile,s.srcLine,"Failed to rename file %s produced by dot to %s!\n",qPrint(dotOutput),qPrint(s.output));
+      ok = FALSE;
+    }
+    else if (s.format.left(3)=="png")
+    {
+      checkPngResult(s.output);
+    }
+  }
+  if (ok) finishOutput();
+  return ok;
+}
+
+bool DotRunner::runSingle()
 {
   int exitCode=0;
 
@@ -178,7 +311,25 @@ bool DotRunner::run()
   QCString srcFile;
   int srcLine=-1;
 
+  bool useCache = !m_md5Hash.isEmpty() && DotCache::instance().isEnabled();
+  if (useCache)
+  {
+    // old output may be a hard link to a file in the dot cache, make sure dot
+    // does not overwrite that file.
+    for (auto& s: m_jobs)
+    {
+      Portable::unlink(s.output);
+    }
+  }
+
   // create output
+#if USE_LIBGVC
+  if (Config_getBool(DOT_IN_PROCESS) && runInProcess(m_file,m_jobs))
+  {
+    // rendered in-process, no need to run dot
+  }
+  else
+#endif
   if (Config_getBool(DOT_MULTI_TARGETS))
   {
     dotArgs=QCString("\"")+m_file+"\"";
@@ -227,6 +378,25 @@ bool DotRunner::run()
     }
   }
 
+  finishOutput();
+  return TRUE;
+error:
+  err_full(srcFile,srcLine,"Problems running dot: exit code=%d, command='%s', arguments='%s'\n",
+    exitCode,qPrint(m_dotExe),qPrint(dotArgs));
+  return FALSE;
+}
+
+void DotRunner::finishOutput()
+{
+  // make the output available to later runs
+  if (!m_md5Hash.isEmpty() && DotCache::instance().isEnabled())
+  {
+    for (auto& s : m_jobs)
+    {
+      DotCache::instance().store(m_md5Hash,s.format,s.output);
+    }
+  }
+
   // remove .dot files
   if (m_cleanUp)
   {
@@ -245,11 +415,6 @@ bool DotRunner::run()
       fclose(f);
     }
   }
-  return TRUE;
-error:
-  err_full(srcFile,srcLine,"Problems running dot: exit code=%d, command='%s', arguments='%s'\n",
-    exitCode,qPrint(m_dotExe),qPrint(dotArgs));
-  return FALSE;
 }
 
 
@@ -300,7 +465,11 @@ void DotWorkerThread::run()
   DotRunner *runner;
   while ((runner=m_queue->dequeue()))
   {
+    auto startTime = std::chrono::steady_clock::now();
     runner->run();
+    auto endTime = std::chrono::steady_clock::now();
+    Scheduler::instance().addDotBusyTime(std::chrono::duration_cast<
+        std::chrono::microseconds>(endTime - startTime).count()/1000000.0);
   }
 }
 
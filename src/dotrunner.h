@@ -53,19 +53,41 @@ class DotRunner
     /** Prevent cleanup of the dot file (for user provided dot files) */
     void preventCleanUp() { m_cleanUp = false; }
 
-    /** Runs dot for all jobs added. */
+    /** Runs dot for all jobs added, including those of the runners in the batch. */
     bool run();
 
     QCString getMd5Hash() { return m_md5Hash; }
 
+    /** Returns a key that is the same for runners whose graphs can be rendered
+     *  by a single dot invocation, or an empty string if this runner has to run on its own.
+     */
+    std::string batchKey() const;
+
+    /** Makes run() also render the graph of \a runner, which has the same batchKey(). */
+    void addToBatch(DotRunner *runner);
+
+    /** Returns the number of graphs rendered by run(). */
+    size_t batchSize() const { return m_batch.size()+1; }
+
+    /** Returns the total size of the dot files rendered by run(). */
+    size_t batchBytes() const { return m_batchBytes; }
+
     static bool readBoundingBox(const QCString &fileName, int* width, int* height, bool isEps);
 
   private:
+    bool runSingle();
+    bool runBatch();
+    bool collectBatchOutput();
+    void finishOutput();
+
     QCString m_file;
     QCString m_md5Hash;
     QCString m_dotExe;
     bool     m_cleanUp;
     std::vector<DotJob>  m_jobs;
+    std::mutex           m_jobsMutex; // graphs can be added by pages rendered in parallel
+    std::vector<DotRunner*> m_batch;
+    size_t   m_batchBytes = 0;
 };
 
 /** Queue of dot jobs to run. */
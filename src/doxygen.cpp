@@ -20,11 +20,17 @@
 
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
+#include <functional>
 #include <memory>
 #include <cinttypes>
+#include <climits>
 #include <chrono>
 #include <clocale>
 #include <locale>
+#include <fstream>
+#include <deque>
+#include <future>
 
 #include "version.h"
 #include "doxygen.h"
@@ -107,6 +113,11 @@
 #include "fileinfo.h"
 #include "dir.h"
 #include "conceptdef.h"
+#include "entrycache.h"
+#include "filecontentcache.h"
+#include "filtercache.h"
+#include "scheduler.h"
+#include "profiler.h"
 
 #if USE_SQLITE3
 #include <sqlite3.h>
@@ -154,13 +165,12 @@ bool                  Doxygen::parseSourcesNeeded = FALSE;
 SearchIndexIntf      *Doxygen::searchIndex=0;
 SymbolMap<Definition>*Doxygen::symbolMap;
 ClangUsrMap          *Doxygen::clangUsrMap = 0;
-Cache<std::string,LookupInfo> *Doxygen::lookupCache;
+ConcurrentCache<std::string,LookupInfo> *Doxygen::lookupCache;
 DirLinkedMap         *Doxygen::dirLinkedMap;
 DirRelationLinkedMap  Doxygen::dirRelations;
 ParserManager        *Doxygen::parserManager = 0;
 QCString              Doxygen::htmlFileExtension;
 bool                  Doxygen::suppressDocWarnings = FALSE;
-QCString              Doxygen::filterDBFileName;
 IndexList            *Doxygen::indexList;
 int                   Doxygen::subpageNestingLevel = 0;
 QCString              Doxygen::spaces;
@@ -213,12 +223,32 @@ class Statistics
       msg("%s", name);
       stats.emplace_back(name,0);
       startTime = std::chrono::steady_clock::now();
+      startUsage = Scheduler::instance().usage();
+      if (Profiler::isEnabled())
+      {
+        Profiler &profiler = Profiler::instance();
+        profiler.begin(name);
+        startCpuTime = Portable::getCpuTime();
+        startAllocations = profiler.numAllocations();
+      }
     }
     void end()
     {
       std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
-      stats.back().elapsed = std::chrono::duration_cast<
+      Scheduler::Usage endUsage = Scheduler::instance().usage();
+      stat &s = stats.back();
+      s.elapsed = std::chrono::duration_cast<
                                 std::chrono::microseconds>(endTime - startTime).count()/1000000.0;
+      s.poolBusyTime = endUsage.poolBusyTime - startUsage.poolBusyTime;
+      s.dotBusyTime  = endUsage.dotBusyTime  - startUsage.dotBusyTime;
+      if (Profiler::isEnabled())
+      {
+        Profiler &profiler = Profiler::instance();
+        profiler.end();
+        s.cpuTime     = Portable::getCpuTime() - startCpuTime;
+        s.peakMemory  = Portable::getPeakMemoryUsage();
+        s.allocations = profiler.numAllocations() - startAllocations;
+      }
     }
     void print()
     {
@@ -229,9 +259,30 @@ class Statistics
         restore=TRUE;
       }
       msg("----------------------\n");
+      Scheduler &scheduler = Scheduler::instance();
+      auto printUsage = [](const char *what,double busyTime,double elapsed,size_t numThreads)
+      {
+        if (busyTime>0.0 && elapsed>0.0)
+        {
+          msg("  %s: %.6f seconds busy, %.1f%% utilisation of %zu threads\n",
+              what,busyTime,100.0*busyTime/(elapsed*static_cast<double>(numThreads)),numThreads);
+        }
+      };
       for (const auto &s : stats)
       {
         msg("Spent %.6f seconds in %s",s.elapsed,s.name);
+        printUsage("thread pool",s.poolBusyTime,s.elapsed,scheduler.numThreads());
+        printUsage("dot workers",s.dotBusyTime,s.elapsed,scheduler.numDotThreads());
+        if (Profiler::isEnabled())
+        {
+          msg("  cpu: %.6f seconds, peak memory: %.1f MB",
+              s.cpuTime,static_cast<double>(s.peakMemory)/(1024.0*1024.0));
+          if (Profiler::countsAllocations())
+          {
+            msg(", allocations: %" PRIu64,s.allocations);
+          }
+          msg("\n");
+        }
       }
       if (restore) Debug::setFlag("time");
     }
@@ -240,11 +291,19 @@ class Statistics
     {
       const char *name;
       double elapsed;
+      double poolBusyTime = 0.0;
+      double dotBusyTime = 0.0;
+      double cpuTime = 0.0;
+      uint64_t peakMemory = 0;
+      uint64_t allocations = 0;
       //stat() : name(NULL),elapsed(0) {}
       stat(const char *n, double el) : name(n),elapsed(el) {}
     };
     std::vector<stat> stats;
     std::chrono::steady_clock::time_point startTime;
+    Scheduler::Usage startUsage;
+    double startCpuTime = 0.0;
+    uint64_t startAllocations = 0;
 } g_s;
 
 
@@ -4993,37 +5052,101 @@ static void computeTemplateClassRelations()
 }
 
 //-----------------------------------------------------------------------
-// compute the references (anchors in HTML) for each function in the file
+// helpers to run a pass over a list of definitions on the thread pool
 
-static void computeMemberReferences()
+/** Calls \a func for each element of \a items. When more than one thread is
+ *  configured, the items are divided into chunks that are processed by the
+ *  shared thread pool. \a func may only modify state owned by the item it is
+ *  called for, so the result does not depend on the processing order.
+ */
+template<class T,class Func>
+static void processInParallel(const std::vector<T> &items,Func func)
 {
-  for (const auto &cd : *Doxygen::classLinkedMap)
+  std::size_t numThreads = Scheduler::instance().numThreads();
+  if (numThreads>1 && items.size()>1) // multi threaded processing
   {
-    ClassDefMutable *cdm = toClassDefMutable(cd.get());
-    if (cdm)
+    ThreadPool &threadPool = Scheduler::instance().threadPool();
+    // use a few chunks per thread to balance the load when some items take longer
+    std::size_t numChunks = std::min(items.size(),numThreads*4);
+    std::size_t chunkSize = (items.size()+numChunks-1)/numChunks;
+    std::vector< std::function<void()> > tasks;
+    for (std::size_t start=0; start<items.size(); start+=chunkSize)
     {
-      cdm->computeAnchors();
+      std::size_t end = std::min(start+chunkSize,items.size());
+      tasks.emplace_back([&items,&func,start,end]()
+      {
+        for (std::size_t i=start; i<end; i++) func(items[i]);
+      });
     }
+    auto results = threadPool.queueBatch(tasks);
+    // wait for the results
+    for (auto &f : results) f.get();
   }
-  for (const auto &fn : *Doxygen::inputNameLinkedMap)
+  else // single threaded processing
   {
-    for (const auto &fd : *fn)
-    {
-      fd->computeAnchors();
-    }
+    for (const auto &item : items) func(item);
+  }
+}
+
+static std::vector<ClassDefMutable*> mutableClasses()
+{
+  std::vector<ClassDefMutable*> result;
+  result.reserve(Doxygen::classLinkedMap->size());
+  for (const auto &cd : *Doxygen::classLinkedMap)
+  {
+    ClassDefMutable *cdm = toClassDefMutable(cd.get());
+    if (cdm) result.push_back(cdm);
   }
+  return result;
+}
+
+static std::vector<NamespaceDefMutable*> mutableNamespaces()
+{
+  std::vector<NamespaceDefMutable*> result;
+  result.reserve(Doxygen::namespaceLinkedMap->size());
   for (const auto &nd : *Doxygen::namespaceLinkedMap)
   {
     NamespaceDefMutable *ndm = toNamespaceDefMutable(nd.get());
-    if (ndm)
+    if (ndm) result.push_back(ndm);
+  }
+  return result;
+}
+
+static std::vector<FileDef*> inputFiles()
+{
+  std::vector<FileDef*> result;
+  for (const auto &fn : *Doxygen::inputNameLinkedMap)
+  {
+    for (const auto &fd : *fn)
     {
-      ndm->computeAnchors();
+      result.push_back(fd.get());
     }
   }
+  return result;
+}
+
+static std::vector<GroupDef*> groups()
+{
+  std::vector<GroupDef*> result;
+  result.reserve(Doxygen::groupLinkedMap->size());
   for (const auto &gd : *Doxygen::groupLinkedMap)
   {
-    gd->computeAnchors();
+    result.push_back(gd.get());
   }
+  return result;
+}
+
+//-----------------------------------------------------------------------
+// compute the references (anchors in HTML) for each function in the file
+
+static void computeMemberReferences()
+{
+  // a member can be part of the lists of a file, namespace, and group at the
+  // same time, so only containers of the same kind are processed concurrently.
+  processInParallel(mutableClasses(),   [](ClassDefMutable *cdm)     { cdm->computeAnchors(); });
+  processInParallel(inputFiles(),       [](FileDef *fd)              { fd->computeAnchors();  });
+  processInParallel(mutableNamespaces(),[](NamespaceDefMutable *ndm) { ndm->computeAnchors(); });
+  processInParallel(groups(),           [](GroupDef *gd)             { gd->computeAnchors();  });
 }
 
 //----------------------------------------------------------------------
@@ -8048,11 +8171,7 @@ static void generateFileSources()
     else
 #endif
     {
-      std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
-      if (numThreads==0)
-      {
-        numThreads = std::thread::hardware_concurrency();
-      }
+      std::size_t numThreads = Scheduler::instance().numThreads();
       if (numThreads>1)
       {
         msg("Generating code files using %zu threads.\n",numThreads);
@@ -8064,7 +8183,7 @@ static void generateFileSources()
           bool generateSourceFile;
           OutputList ol;
         };
-        ThreadPool threadPool(numThreads);
+        ThreadPool &threadPool = Scheduler::instance().threadPool();
         std::vector< std::future< std::shared_ptr<SourceContext> > > results;
         for (const auto &fn : *Doxygen::inputNameLinkedMap)
         {
@@ -8098,7 +8217,9 @@ static void generateFileSources()
               }
               return ctx;
             };
-            results.emplace_back(threadPool.queue(processFile));
+            // start with the biggest files
+            int priority = static_cast<int>(std::min<size_t>(FileInfo(fd->absFilePath().str()).size()/1024,INT_MAX));
+            results.emplace_back(threadPool.queue(processFile,priority));
           }
         }
         for (auto &f : results)
@@ -8146,11 +8267,7 @@ static void generateFileDocs()
 
   if (!Doxygen::inputNameLinkedMap->empty())
   {
-    std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
-    if (numThreads==0)
-    {
-      numThreads = std::thread::hardware_concurrency();
-    }
+    std::size_t numThreads = Scheduler::instance().numThreads();
     if (numThreads>1) // multi threaded processing
     {
       struct DocContext
@@ -8160,7 +8277,7 @@ static void generateFileDocs()
         FileDef *fd;
         OutputList ol;
       };
-      ThreadPool threadPool(numThreads);
+      ThreadPool &threadPool = Scheduler::instance().threadPool();
       std::vector< std::future< std::shared_ptr<DocContext> > > results;
       for (const auto &fn : *Doxygen::inputNameLinkedMap)
       {
@@ -8322,39 +8439,16 @@ static void buildDefineList()
 static void sortMemberLists()
 {
   // sort class member lists
-  for (const auto &cd : *Doxygen::classLinkedMap)
-  {
-    ClassDefMutable *cdm = toClassDefMutable(cd.get());
-    if (cdm)
-    {
-      cdm->sortMemberLists();
-    }
-  }
+  processInParallel(mutableClasses(),   [](ClassDefMutable *cdm)     { cdm->sortMemberLists(); });
 
   // sort namespace member lists
-  for (const auto &nd : *Doxygen::namespaceLinkedMap)
-  {
-    NamespaceDefMutable *ndm = toNamespaceDefMutable(nd.get());
-    if (ndm)
-    {
-      ndm->sortMemberLists();
-    }
-  }
+  processInParallel(mutableNamespaces(),[](NamespaceDefMutable *ndm) { ndm->sortMemberLists(); });
 
   // sort file member lists
-  for (const auto &fn : *Doxygen::inputNameLinkedMap)
-  {
-    for (const auto &fd : *fn)
-    {
-      fd->sortMemberLists();
-    }
-  }
+  processInParallel(inputFiles(),       [](FileDef *fd)              { fd->sortMemberLists();  });
 
   // sort group member lists
-  for (const auto &gd : *Doxygen::groupLinkedMap)
-  {
-    gd->sortMemberLists();
-  }
+  processInParallel(groups(),           [](GroupDef *gd)             { gd->sortMemberLists();  });
 }
 
 //----------------------------------------------------------------------------
@@ -8368,64 +8462,38 @@ static bool isSymbolHidden(const Definition *d)
 
 static void computeTooltipTexts()
 {
+  // a definition can be registered under multiple names, make sure it is
+  // only processed once
+  std::vector<DefinitionMutable*> defs;
+  std::unordered_set<DefinitionMutable*> seen;
   for (const auto &kv : *Doxygen::symbolMap)
   {
     DefinitionMutable *dm = toDefinitionMutable(kv.second);
-    if (dm && !isSymbolHidden(toDefinition(dm)) && toDefinition(dm)->isLinkableInProject())
+    if (dm && !isSymbolHidden(toDefinition(dm)) && toDefinition(dm)->isLinkableInProject() &&
+        seen.insert(dm).second)
     {
-      dm->computeTooltip();
+      defs.push_back(dm);
     }
   }
+  processInParallel(defs,[](DefinitionMutable *dm) { dm->computeTooltip(); });
 }
 
 //----------------------------------------------------------------------------
 
 static void setAnonymousEnumType()
 {
-  for (const auto &cd : *Doxygen::classLinkedMap)
-  {
-    ClassDefMutable *cdm = toClassDefMutable(cd.get());
-    if (cdm)
-    {
-      cdm->setAnonymousEnumType();
-    }
-  }
+  processInParallel(mutableClasses(),[](ClassDefMutable *cdm) { cdm->setAnonymousEnumType(); });
 }
 
 //----------------------------------------------------------------------------
 
 static void countMembers()
 {
-  for (const auto &cd : *Doxygen::classLinkedMap)
-  {
-    ClassDefMutable *cdm = toClassDefMutable(cd.get());
-    if (cdm)
-    {
-      cdm->countMembers();
-    }
-  }
-
-  for (const auto &nd : *Doxygen::namespaceLinkedMap)
-  {
-    NamespaceDefMutable *ndm = toNamespaceDefMutable(nd.get());
-    if (ndm)
-    {
-      ndm->countMembers();
-    }
-  }
-
-  for (const auto &fn : *Doxygen::inputNameLinkedMap)
-  {
-    for (const auto &fd : *fn)
-    {
-      fd->countMembers();
-    }
-  }
-
-  for (const auto &gd : *Doxygen::groupLinkedMap)
-  {
-    gd->countMembers();
-  }
+  // the counts are stored in the member lists, which are owned by a single definition
+  processInParallel(mutableClasses(),   [](ClassDefMutable *cdm)     { cdm->countMembers(); });
+  processInParallel(mutableNamespaces(),[](NamespaceDefMutable *ndm) { ndm->countMembers(); });
+  processInParallel(inputFiles(),       [](FileDef *fd)              { fd->countMembers();  });
+  processInParallel(groups(),           [](GroupDef *gd)             { gd->countMembers();  });
 }
 
 
@@ -8434,11 +8502,7 @@ static void countMembers()
 
 static void generateClassList(const ClassLinkedMap &classList)
 {
-  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
-  if (numThreads==0)
-  {
-    numThreads = std::thread::hardware_concurrency();
-  }
+  std::size_t numThreads = Scheduler::instance().numThreads();
   if (numThreads>1) // multi threaded processing
   {
     struct DocContext
@@ -8448,7 +8512,7 @@ static void generateClassList(const ClassLinkedMap &classList)
       ClassDefMutable *cd;
       OutputList ol;
     };
-    ThreadPool threadPool(numThreads);
+    ThreadPool &threadPool = Scheduler::instance().threadPool();
     std::vector< std::future< std::shared_ptr<DocContext> > > results;
     for (const auto &cdi : classList)
     {
@@ -8737,19 +8801,8 @@ static void flushCachedTemplateRelations()
   // as there can be new template instances in the inheritance path
   // to this class. Optimization: only remove those classes that
   // have inheritance instances as direct or indirect sub classes.
-  StringVector elementsToRemove;
-  for (const auto &ci : *Doxygen::lookupCache)
-  {
-    const LookupInfo &li = ci.second;
-    if (li.classDef)
-    {
-      elementsToRemove.push_back(ci.first);
-    }
-  }
-  for (const auto &k : elementsToRemove)
-  {
-    Doxygen::lookupCache->remove(k);
-  }
+  Doxygen::lookupCache->removeIf([](const std::string &,const LookupInfo &li)
+      { return li.classDef!=0; });
 
   // remove all cached typedef resolutions whose target is a
   // template class as this may now be a template instance
@@ -8797,19 +8850,8 @@ static void flushUnresolvedRelations()
   // class B : public A {};
   // class C : public B::I {};
 
-  StringVector elementsToRemove;
-  for (const auto &ci : *Doxygen::lookupCache)
-  {
-    const LookupInfo &li = ci.second;
-    if (li.classDef==0 && li.typeDef==0)
-    {
-      elementsToRemove.push_back(ci.first);
-    }
-  }
-  for (const auto &k : elementsToRemove)
-  {
-    Doxygen::lookupCache->remove(k);
-  }
+  Doxygen::lookupCache->removeIf([](const std::string &,const LookupInfo &li)
+      { return li.classDef==0 && li.typeDef==0; });
 
   // for each global function name
   for (const auto &fn : *Doxygen::functionNameLinkedMap)
@@ -9382,11 +9424,7 @@ static void generateGroupDocs()
 
 static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList)
 {
-  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
-  if (numThreads==0)
-  {
-    numThreads = std::thread::hardware_concurrency();
-  }
+  std::size_t numThreads = Scheduler::instance().numThreads();
   if (numThreads>1) // multi threaded processing
   {
     struct DocContext
@@ -9396,7 +9434,7 @@ static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList)
       ClassDefMutable *cdm;
       OutputList ol;
     };
-    ThreadPool threadPool(numThreads);
+    ThreadPool &threadPool = Scheduler::instance().threadPool();
     std::vector< std::future< std::shared_ptr<DocContext> > > results;
     // for each class in the namespace...
     for (const auto &cd : classList)
@@ -9827,6 +9865,7 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
                       FileDef *fd,const QCString &fn,
                       ClangTUParser *clangParser,bool newTU)
 {
+  ProfileScope profile("parse file",fn);
   QCString fileName=fn;
   QCString extension;
   int ei = fileName.findRev('.');
@@ -9874,14 +9913,27 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
 
   convBuf.addChar('\0');
 
-  std::shared_ptr<Entry> fileRoot = std::make_shared<Entry>();
+  // reuse the result of a previous run if the parser input did not change
+  EntryCache &entryCache = EntryCache::instance();
+  QCString cacheKey = clangParser ? QCString() : entryCache.key(fileName,convBuf);
+  std::shared_ptr<Entry> fileRoot = entryCache.load(cacheKey);
+  if (fileRoot)
+  {
+    msg("Using cached parse result for %s...\n",qPrint(fn));
+    fileRoot->setFileDef(fd);
+    return fileRoot;
+  }
+
+  fileRoot = std::make_shared<Entry>();
   // use language parse to parse the file
   if (clangParser)
   {
     if (newTU) clangParser->parse();
     clangParser->switchToFile(fd);
   }
+  entryCache.beginParse();
   parser.parseInput(fileName,convBuf.data(),fileRoot,clangParser);
+  entryCache.store(cacheKey,fileRoot.get());
   fileRoot->setFileDef(fd);
   return fileRoot;
 }
@@ -9903,13 +9955,9 @@ static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
 
     std::mutex processedFilesLock;
     // process source files (and their include dependencies)
-    std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
-    if (numThreads==0)
-    {
-      numThreads = std::thread::hardware_concurrency();
-    }
+    std::size_t numThreads = Scheduler::instance().numThreads();
     msg("Processing input using %zu threads.\n",numThreads);
-    ThreadPool threadPool(numThreads);
+    ThreadPool &threadPool = Scheduler::instance().threadPool();
     using FutureType = std::vector< std::shared_ptr<Entry> >;
     std::vector< std::future< FutureType > > results;
     for (const auto &s : g_inputFiles)
@@ -10002,11 +10050,14 @@ static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
   else // normal processing
 #endif
   {
-    std::size_t numThreads = std::thread::hardware_concurrency();
+    std::size_t numThreads = Scheduler::instance().numThreads();
     msg("Processing input using %zu threads.\n",numThreads);
-    ThreadPool threadPool(numThreads);
-    using FutureType = std::shared_ptr<Entry>;
-    std::vector< std::future< FutureType > > results;
+    ThreadPool &threadPool = Scheduler::instance().threadPool();
+    using ProcessFunc = std::function< std::shared_ptr<Entry>() >;
+    std::vector< ProcessFunc > jobs;
+    std::vector< int > priorities;
+    jobs.reserve(g_inputFiles.size());
+    priorities.reserve(g_inputFiles.size());
     for (const auto &s : g_inputFiles)
     {
       // lambda representing the work to executed by a thread
@@ -10017,9 +10068,12 @@ static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
         auto fileRoot = parseFile(*parser.get(),fd,s.c_str(),nullptr,true);
         return fileRoot;
       };
-      // dispatch the work and collect the future results
-      results.emplace_back(threadPool.queue(processFile));
+      jobs.push_back(processFile);
+      // parse big files first, so they do not end up as the last job of a thread
+      priorities.push_back(static_cast<int>(std::min<size_t>(FileInfo(s).size()/1024,INT_MAX)));
     }
+    // dispatch the work and collect the future results
+    auto results = threadPool.queueBatch(jobs,priorities);
     // synchronise with the Entry results produced and add them to the root
     for (auto &f : results)
     {
@@ -10176,39 +10230,136 @@ static std::string resolveSymlink(const std::string &path)
 
 static StringUnorderedSet g_pathsVisited(1009);
 
+/** @brief An entry of a directory that passed the filters of readFileOrDirectory() */
+struct DirEntryInfo
+{
+  enum class Kind { Unreadable, File, Dir };
+  Kind        kind;
+  std::string absFilePath;
+  std::string name;        // for files: the file name
+  std::string dirPath;     // for files: the directory path, ending with a '/'
+  std::string subDirName;  // for directories: the path to read, symlinks resolved;
+                           // empty for a recursive symlink
+};
+
+using DirListings = std::unordered_map< std::string, std::vector<DirEntryInfo> >;
+
+/** @brief The filters applied while reading directories */
+struct DirFilter
+{
+  const StringUnorderedSet *exclSet;
+  const FilePatternMatcher *patMatcher;
+  const FilePatternMatcher *exclPatMatcher;
+  bool recursive;
+  bool excludeSymlinks;
+};
+
+// Lists the entries of directory 'dirName' that pass the filter.
+// Only reads the file system, so it can run on any thread.
+static std::vector<DirEntryInfo> listDir(const std::string &dirName,const DirFilter &filter)
+{
+  std::vector<DirEntryInfo> result;
+  Dir dir(dirName);
+  for (const auto &dirEntry : dir.iterator())
+  {
+    FileInfo cfi(dirEntry.path());
+    if (filter.exclSet==0 || filter.exclSet->find(cfi.absFilePath())==filter.exclSet->end())
+    { // file should not be excluded
+      if (!cfi.exists() || !cfi.isReadable())
+      {
+        result.push_back(DirEntryInfo{ DirEntryInfo::Kind::Unreadable, cfi.absFilePath(), "", "", "" });
+      }
+      else if (cfi.isFile() &&
+          (!filter.excludeSymlinks || !cfi.isSymLink()) &&
+          (filter.patMatcher==0 || filter.patMatcher->match(cfi)) &&
+          (filter.exclPatMatcher==0 || !filter.exclPatMatcher->match(cfi))
+          )
+      {
+        result.push_back(DirEntryInfo{ DirEntryInfo::Kind::File, cfi.absFilePath(),
+                                       cfi.fileName(), cfi.dirPath()+"/", "" });
+      }
+      else if (filter.recursive &&
+          (!filter.excludeSymlinks || !cfi.isSymLink()) &&
+          cfi.isDir() &&
+          (filter.exclPatMatcher==0 || !filter.exclPatMatcher->match(cfi)) &&
+          cfi.fileName().at(0)!='.') // skip "." ".." and ".dir"
+      {
+        std::string absPath = cfi.absFilePath();
+        std::string subDirName = cfi.isSymLink() ? resolveSymlink(absPath) : absPath;
+        result.push_back(DirEntryInfo{ DirEntryInfo::Kind::Dir, absPath, "", "", subDirName });
+      }
+    }
+  }
+  return result;
+}
+
+// Lists directory 'rootDir' and all directories below it that pass the filter.
+// The directories are read in parallel on the thread pool.
+static DirListings crawlDirs(const std::string &rootDir,const DirFilter &filter)
+{
+  DirListings listings;
+  StringUnorderedSet queued;
+  std::deque< std::pair< std::string, std::future< std::vector<DirEntryInfo> > > > pending;
+  ThreadPool *pool = Scheduler::instance().numThreads()>1 ? &Scheduler::instance().threadPool() : 0;
+  auto addDir = [&](const std::string &dirName)
+  {
+    if (dirName.empty() || !queued.insert(dirName).second) return;
+    auto list = [dirName,&filter]() { return listDir(dirName,filter); };
+    if (pool)
+    {
+      pending.emplace_back(dirName,pool->queue(list));
+    }
+    else // read in place
+    {
+      std::promise< std::vector<DirEntryInfo> > result;
+      result.set_value(list());
+      pending.emplace_back(dirName,result.get_future());
+    }
+  };
+  addDir(rootDir);
+  while (!pending.empty())
+  {
+    std::string dirName = pending.front().first;
+    std::vector<DirEntryInfo> entries = pending.front().second.get();
+    pending.pop_front();
+    for (const auto &entry : entries)
+    {
+      if (entry.kind==DirEntryInfo::Kind::Dir) addDir(entry.subDirName);
+    }
+    listings.insert(std::make_pair(dirName,std::move(entries)));
+  }
+  return listings;
+}
+
 //----------------------------------------------------------------------------
 // Read all files matching at least one pattern in 'patList' in the
 // directory represented by 'fi'.
 // The directory is read iff the recursiveFlag is set.
 // The contents of all files is append to the input string
+//
+// The directories have been listed by crawlDirs() before. They are visited
+// here in the same depth first order as they are found on disk, so the
+// results do not depend on the order in which the crawler read them.
 
-static void readDir(FileInfo *fi,
+static void readDir(const std::string &absPath,
+            const std::string &dirName,
+            const DirListings &listings,
             FileNameLinkedMap *fnMap,
-            StringUnorderedSet *exclSet,
-            const StringVector *patList,
-            const StringVector *exclPatList,
             StringVector *resultList,
             StringUnorderedSet *resultSet,
             bool errorIfNotExist,
-            bool recursive,
             StringUnorderedSet *killSet,
             StringSet *paths
            )
 {
-  std::string dirName = fi->absFilePath();
-  if (paths && !dirName.empty())
+  if (paths && !absPath.empty())
   {
-    paths->insert(dirName);
+    paths->insert(absPath);
   }
-  //printf("%s isSymLink()=%d\n",qPrint(dirName),fi->isSymLink());
-  if (fi->isSymLink())
+  if (dirName.empty())
   {
-    dirName = resolveSymlink(dirName);
-    if (dirName.empty())
-    {
-      //printf("RECURSIVE SYMLINK: %s\n",qPrint(dirName));
-      return;  // recursive symlink
-    }
+    //printf("RECURSIVE SYMLINK: %s\n",qPrint(absPath));
+    return;  // recursive symlink
   }
 
   if (g_pathsVisited.find(dirName)!=g_pathsVisited.end())
@@ -10218,67 +10369,48 @@ static void readDir(FileInfo *fi,
   }
   g_pathsVisited.insert(dirName);
 
-  Dir dir(dirName);
-  msg("Searching for files in directory %s\n", qPrint(fi->absFilePath()));
+  auto it = listings.find(dirName);
+  if (it==listings.end()) return; // should not happen
+  msg("Searching for files in directory %s\n", absPath.c_str());
   //printf("killSet=%p count=%d\n",killSet,killSet ? (int)killSet->count() : -1);
 
-  for (const auto &dirEntry : dir.iterator())
+  for (const auto &entry : it->second)
   {
-    FileInfo cfi(dirEntry.path());
-    if (exclSet==0 || exclSet->find(cfi.absFilePath())==exclSet->end())
-    { // file should not be excluded
-      //printf("killSet->find(%s)\n",qPrint(cfi->absFilePath()));
-      if (!cfi.exists() || !cfi.isReadable())
-      {
+    switch (entry.kind)
+    {
+      case DirEntryInfo::Kind::Unreadable:
         if (errorIfNotExist)
         {
-          warn_uncond("source '%s' is not a readable file or directory... skipping.\n",cfi.absFilePath().c_str());
+          warn_uncond("source '%s' is not a readable file or directory... skipping.\n",entry.absFilePath.c_str());
         }
-      }
-      else if (cfi.isFile() &&
-          (!Config_getBool(EXCLUDE_SYMLINKS) || !cfi.isSymLink()) &&
-          (patList==0 || patternMatch(cfi,*patList)) &&
-          (exclPatList==0 || !patternMatch(cfi,*exclPatList)) &&
-          (killSet==0 || killSet->find(cfi.absFilePath())==killSet->end())
-          )
-      {
-        std::string name=cfi.fileName();
-        std::string path=cfi.dirPath()+"/";
-        std::string fullName=path+name;
-        if (fnMap)
+        break;
+      case DirEntryInfo::Kind::File:
+        //printf("killSet->find(%s)\n",qPrint(entry.absFilePath));
+        if (killSet==0 || killSet->find(entry.absFilePath)==killSet->end())
         {
-          std::unique_ptr<FileDef> fd { createFileDef(QCString(path),QCString(name)) };
-          FileName *fn=0;
-          if (!name.empty())
+          const std::string &name=entry.name;
+          std::string fullName=entry.dirPath+name;
+          if (fnMap)
           {
-            fn = fnMap->add(QCString(name),QCString(fullName));
-            fn->push_back(std::move(fd));
+            std::unique_ptr<FileDef> fd { createFileDef(QCString(entry.dirPath),QCString(name)) };
+            FileName *fn=0;
+            if (!name.empty())
+            {
+              fn = fnMap->add(QCString(name),QCString(fullName));
+              fn->push_back(std::move(fd));
+            }
           }
+          if (resultList) resultList->push_back(fullName);
+          if (resultSet) resultSet->insert(fullName);
+          if (killSet) killSet->insert(fullName);
         }
-        if (resultList) resultList->push_back(fullName);
-        if (resultSet) resultSet->insert(fullName);
-        if (killSet) killSet->insert(fullName);
-      }
-      else if (recursive &&
-          (!Config_getBool(EXCLUDE_SYMLINKS) || !cfi.isSymLink()) &&
-          cfi.isDir() &&
-          (exclPatList==0 || !patternMatch(cfi,*exclPatList)) &&
-          cfi.fileName().at(0)!='.') // skip "." ".." and ".dir"
-      {
-        FileInfo acfi(cfi.absFilePath());
-        readDir(&acfi,fnMap,exclSet,
-            patList,exclPatList,resultList,resultSet,errorIfNotExist,
-            recursive,killSet,paths);
-      }
+        break;
+      case DirEntryInfo::Kind::Dir:
+        readDir(entry.absFilePath,entry.subDirName,listings,fnMap,
+            resultList,resultSet,errorIfNotExist,killSet,paths);
+        break;
     }
   }
-  if (resultList)
-  {
-    // sort the resulting list to make the order platform independent.
-    std::sort(resultList->begin(),
-              resultList->end(),
-              [](const auto &f1,const auto &f2) { return qstricmp(f1.c_str(),f2.c_str())<0; });
-  }
 }
 
 
@@ -10351,9 +10483,25 @@ void readFileOrDirectory(const QCString &s,
         }
         else if (fi.isDir()) // readable dir
         {
-          readDir(&fi,fnMap,exclSet,patList,
-              exclPatList,resultList,resultSet,errorIfNotExist,
-              recursive,killSet,paths);
+          // compile the patterns once for the whole directory tree
+          std::unique_ptr<FilePatternMatcher> patMatcher;
+          std::unique_ptr<FilePatternMatcher> exclPatMatcher;
+          if (patList)     patMatcher     = std::make_unique<FilePatternMatcher>(*patList);
+          if (exclPatList) exclPatMatcher = std::make_unique<FilePatternMatcher>(*exclPatList);
+          DirFilter filter { exclSet, patMatcher.get(), exclPatMatcher.get(),
+                             recursive, Config_getBool(EXCLUDE_SYMLINKS) };
+          std::string absPath = fi.absFilePath();
+          std::string dirName = fi.isSymLink() ? resolveSymlink(absPath) : absPath;
+          DirListings listings = crawlDirs(dirName,filter);
+          readDir(absPath,dirName,listings,fnMap,
+              resultList,resultSet,errorIfNotExist,killSet,paths);
+          if (resultList)
+          {
+            // sort the resulting list to make the order platform independent.
+            std::sort(resultList->begin(),
+                      resultList->end(),
+                      [](const auto &f1,const auto &f2) { return qstricmp(f1.c_str(),f2.c_str())<0; });
+          }
         }
       }
     }
@@ -10712,18 +10860,37 @@ void cleanUpDoxygen()
   delete Doxygen::symbolMap;
 
   DotManager::deleteInstance();
+  Scheduler::instance().shutdown();
 }
 
-static int computeIdealCacheParam(size_t v)
+static const size_t lookupCacheEntrySize = 256;   // estimated memory used per entry, in bytes
+static const size_t minLookupCacheSize   = 65536; // number of entries
+
+//! returns the name of the file that stores the size of the lookup cache between runs
+static QCString lookupCacheSizeFileName()
 {
-  //printf("computeIdealCacheParam(v=%u)\n",v);
+  return Config_getString(OUTPUT_DIRECTORY)+"/doxygen_lookup_cache_size";
+}
 
-  int r=0;
-  while (v!=0) v>>=1,r++;
-  // r = log2(v)
+//! returns the lookup cache size stored by the previous run, or 0 if there is none
+static size_t readLookupCacheSize()
+{
+  std::ifstream f(lookupCacheSizeFileName().str(),std::ifstream::in);
+  size_t size=0;
+  if (f.is_open() && !(f >> size))
+  {
+    size=0;
+  }
+  return size;
+}
 
-  // convert to a valid cache size value
-  return std::max(0,std::min(r-16,9));
+static void writeLookupCacheSize(size_t size)
+{
+  std::ofstream f(lookupCacheSizeFileName().str(),std::ofstream::out | std::ofstream::trunc);
+  if (f.is_open())
+  {
+    f << size << "\n";
+  }
 }
 
 void readConfiguration(int argc, char **argv)
@@ -11219,12 +11386,7 @@ void adjustConfiguration()
 #ifdef HAS_SIGNALS
 static void stopDoxygen(int)
 {
-  Dir thisDir;
   msg("Cleaning up...\n");
-  if (!Doxygen::filterDBFileName.isEmpty())
-  {
-    thisDir.remove(Doxygen::filterDBFileName.str());
-  }
   killpg(0,SIGINT);
   cleanUpDoxygen();
   exit(1);
@@ -11307,12 +11469,7 @@ static void exitDoxygen()
 {
   if (!g_successfulRun)  // premature exit
   {
-    Dir thisDir;
     msg("Exiting...\n");
-    if (!Doxygen::filterDBFileName.isEmpty())
-    {
-      thisDir.remove(Doxygen::filterDBFileName.str());
-    }
   }
 }
 
@@ -11593,21 +11750,16 @@ void parseInput()
    *            Initialize global lists and dictionaries
    **************************************************************************/
 
-  // also scale lookup cache with SYMBOL_CACHE_SIZE
-  int cacheSize = Config_getInt(LOOKUP_CACHE_SIZE);
-  if (cacheSize<0) cacheSize=0;
-  if (cacheSize>9) cacheSize=9;
-  uint lookupSize = 65536 << cacheSize;
-  Doxygen::lookupCache = new Cache<std::string,LookupInfo>(lookupSize);
+  // the lookup cache adapts its size, starting from the size learned in the previous run
+  size_t maxLookupSize = static_cast<size_t>(Config_getInt(LOOKUP_CACHE_MEMORY))*1024*1024/lookupCacheEntrySize;
+  size_t lookupSize = std::min(std::max(readLookupCacheSize(),minLookupCacheSize),maxLookupSize);
+  Doxygen::lookupCache = new ConcurrentCache<std::string,LookupInfo>(lookupSize);
+  Doxygen::lookupCache->setAdaptive(std::min(minLookupCacheSize,maxLookupSize),maxLookupSize);
 
 #ifdef HAS_SIGNALS
   signal(SIGINT, stopDoxygen);
 #endif
 
-  uint pid = Portable::pid();
-  Doxygen::filterDBFileName.sprintf("doxygen_filterdb_%d.tmp",pid);
-  Doxygen::filterDBFileName.prepend(outputDirectory+"/");
-
   /**************************************************************************
    *            Check/create output directories                             *
    **************************************************************************/
@@ -11774,7 +11926,9 @@ void parseInput()
   addSTLSupport(root);
 
   g_s.begin("Parsing files\n");
-  if (Config_getInt(NUM_PROC_THREADS)==1)
+  FilterCache::instance().initialize();
+  EntryCache::instance().initialize();
+  if (Scheduler::instance().numThreads()==1)
   {
     parseFilesSingleThreading(root);
   }
@@ -11782,6 +11936,7 @@ void parseInput()
   {
     parseFilesMultiThreading(root);
   }
+  EntryCache::instance().finish();
   g_s.end();
 
   /**************************************************************************
@@ -12485,25 +12640,33 @@ void generateOutput()
 
   g_outputList->cleanup();
 
-  int cacheParam;
   msg("lookup cache used %zu/%zu hits=%" PRIu64 " misses=%" PRIu64 "\n",
       Doxygen::lookupCache->size(),
       Doxygen::lookupCache->capacity(),
       Doxygen::lookupCache->hits(),
       Doxygen::lookupCache->misses());
-  cacheParam = computeIdealCacheParam(static_cast<size_t>(Doxygen::lookupCache->misses()*2/3)); // part of the cache is flushed, hence the 2/3 correction factor
-  if (cacheParam>Config_getInt(LOOKUP_CACHE_SIZE))
-  {
-    msg("Note: based on cache misses the ideal setting for LOOKUP_CACHE_SIZE is %d at the cost of higher memory usage.\n",cacheParam);
-  }
+  writeLookupCacheSize(Doxygen::lookupCache->capacity());
+  FilterCache::instance().finish();
+  msg("input file cache used %zu bytes hits=%" PRIu64 " misses=%" PRIu64 "\n",
+      FileContentCache::instance().size(),
+      FileContentCache::instance().hits(),
+      FileContentCache::instance().misses());
 
-  if (Debug::isFlagSet(Debug::Time))
+  if (Debug::isFlagSet(Debug::Time) || Profiler::isEnabled())
   {
     msg("Total elapsed time: %.6f seconds\n(of which %.6f seconds waiting for external tools to finish)\n",
          ((double)Debug::elapsedTime()),
          Portable::getSysElapsedTime()
         );
     g_s.print();
+    if (Profiler::isEnabled())
+    {
+      Profiler &profiler = Profiler::instance();
+      profiler.printSummary();
+      QCString traceFile = Config_getString(OUTPUT_DIRECTORY)+"/doxygen_trace.json";
+      profiler.writeTrace(traceFile);
+      msg("Trace of the run written to %s\n",qPrint(traceFile));
+    }
   }
   else
   {
@@ -12518,8 +12681,6 @@ void generateOutput()
   cleanUpDoxygen();
 
   finalizeSearchIndexer();
-  Dir thisDir;
-  thisDir.remove(Doxygen::filterDBFileName.str());
   finishWarnExit();
   Config::deinit();
   delete Doxygen::clangUsrMap;
@@ -105,12 +105,11 @@ class Doxygen
     static SearchIndexIntf          *searchIndex;
     static SymbolMap<Definition>    *symbolMap;
     static ClangUsrMap              *clangUsrMap;
-    static Cache<std::string,LookupInfo> *lookupCache;
+    static ConcurrentCache<std::string,LookupInfo> *lookupCache;
     static DirLinkedMap             *dirLinkedMap;
     static DirRelationLinkedMap      dirRelations;
     static ParserManager            *parserManager;
     static bool                      suppressDocWarnings;
-    static QCString                  filterDBFileName;
     static IndexList                *indexList;
     static int                       subpageNestingLevel;
     static QCString                  spaces;
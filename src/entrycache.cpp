@@ -0,0 +1,632 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "entrycache.h"
+#include "entry.h"
+#include "bufstr.h"
+#include "config.h"
+#include "message.h"
+#include "doxygen.h"
+#include "containers.h"
+#include "fileinfo.h"
+#include "dir.h"
+#include "md5.h"
+#include "version.h"
+
+// magic number and version of the on-disk format, increase the version
+// whenever the layout of the Entry class changes.
+static const char   *g_cacheMagic   = "DXEC";
+static const int     g_cacheVersion = 1;
+static const char   *g_cacheExt     = ".entry";
+
+static THREAD_LOCAL bool g_parseHasSideEffects = false;
+
+//---------------------------------------------------------------------------
+
+/** Helper to write the fields of an Entry tree to a binary stream */
+class EntryWriter
+{
+  public:
+    EntryWriter(std::ostream &os) : m_os(os) {}
+    void writeInt(int i)
+    {
+      m_os.write(reinterpret_cast<const char*>(&i),sizeof(i));
+    }
+    void writeUInt64(uint64 i)
+    {
+      m_os.write(reinterpret_cast<const char*>(&i),sizeof(i));
+    }
+    void writeBool(bool b)
+    {
+      char c = b ? 1 : 0;
+      m_os.write(&c,1);
+    }
+    void writeString(const std::string &s)
+    {
+      writeInt(static_cast<int>(s.length()));
+      m_os.write(s.data(),s.length());
+    }
+    void writeString(const QCString &s)
+    {
+      writeInt(static_cast<int>(s.length()));
+      m_os.write(s.data(),s.length());
+    }
+    void writeArgumentList(const ArgumentList &al)
+    {
+      writeInt(static_cast<int>(al.size()));
+      for (const Argument &a : al)
+      {
+        writeString(a.attrib);
+        writeString(a.type);
+        writeString(a.canType);
+        writeString(a.name);
+        writeString(a.array);
+        writeString(a.defval);
+        writeString(a.docs);
+        writeString(a.typeConstraint);
+      }
+      writeBool(al.constSpecifier());
+      writeBool(al.volatileSpecifier());
+      writeBool(al.pureSpecifier());
+      writeString(al.trailingReturnType());
+      writeBool(al.isDeleted());
+      writeInt(al.refQualifier());
+      writeBool(al.noParameters());
+    }
+    void writeEntry(const Entry *e)
+    {
+      writeInt(e->section);
+      writeString(e->type);
+      writeString(e->name);
+      writeBool(e->hasTagInfo);
+      writeString(e->tagInfoData.tagName);
+      writeString(e->tagInfoData.fileName);
+      writeString(e->tagInfoData.anchor);
+      writeInt(e->protection);
+      writeInt(e->mtype);
+      writeUInt64(e->spec);
+      writeInt(e->initLines);
+      writeBool(e->stat);
+      writeBool(e->explicitExternal);
+      writeBool(e->proto);
+      writeBool(e->subGrouping);
+      writeBool(e->callGraph);
+      writeBool(e->callerGraph);
+      writeBool(e->referencedByRelation);
+      writeBool(e->referencesRelation);
+      writeInt(e->virt);
+      writeString(e->args);
+      writeString(e->bitfields);
+      writeArgumentList(e->argList);
+      writeInt(static_cast<int>(e->tArgLists.size()));
+      for (const ArgumentList &al : e->tArgLists)
+      {
+        writeArgumentList(al);
+      }
+      writeString(e->program.str());
+      writeString(e->initializer.str());
+      writeString(e->includeFile);
+      writeString(e->includeName);
+      writeString(e->doc);
+      writeInt(e->docLine);
+      writeString(e->docFile);
+      writeString(e->brief);
+      writeInt(e->briefLine);
+      writeString(e->briefFile);
+      writeString(e->inbodyDocs);
+      writeInt(e->inbodyLine);
+      writeString(e->inbodyFile);
+      writeString(e->relates);
+      writeInt(e->relatesType);
+      writeString(e->read);
+      writeString(e->write);
+      writeString(e->inside);
+      writeString(e->exception);
+      writeArgumentList(e->typeConstr);
+      writeInt(e->bodyLine);
+      writeInt(e->bodyColumn);
+      writeInt(e->endBodyLine);
+      writeInt(static_cast<int>(e->extends.size()));
+      for (const BaseInfo &bi : e->extends)
+      {
+        writeString(bi.name);
+        writeInt(bi.prot);
+        writeInt(bi.virt);
+      }
+      writeInt(static_cast<int>(e->groups.size()));
+      for (const Grouping &g : e->groups)
+      {
+        writeString(g.groupname);
+        writeInt(g.pri);
+      }
+      writeString(e->fileName);
+      writeInt(e->startLine);
+      writeInt(e->startColumn);
+      writeInt(e->lang);
+      writeBool(e->hidden);
+      writeBool(e->artificial);
+      writeInt(e->groupDocType);
+      writeString(e->id);
+      writeInt(e->localToc.mask());
+      writeInt(e->localToc.htmlLevel());
+      writeInt(e->localToc.latexLevel());
+      writeInt(e->localToc.xmlLevel());
+      writeInt(e->localToc.docbookLevel());
+      writeString(e->metaData);
+      writeString(e->req);
+      writeInt(static_cast<int>(e->children().size()));
+      for (const auto &child : e->children())
+      {
+        writeEntry(child.get());
+      }
+    }
+  private:
+    std::ostream &m_os;
+};
+
+//---------------------------------------------------------------------------
+
+/** Helper to read an Entry tree written by EntryWriter from a memory buffer */
+class EntryReader
+{
+  public:
+    EntryReader(const std::string &data) : m_p(data.data()), m_end(data.data()+data.length()) {}
+    bool isValid() const { return m_ok; }
+    bool atEnd() const { return m_p==m_end; }
+    int readInt()
+    {
+      int i=0;
+      readRaw(&i,sizeof(i));
+      return i;
+    }
+    uint64 readUInt64()
+    {
+      uint64 i=0;
+      readRaw(&i,sizeof(i));
+      return i;
+    }
+    bool readBool()
+    {
+      char c=0;
+      readRaw(&c,1);
+      return c!=0;
+    }
+    QCString readString()
+    {
+      int len = readInt();
+      if (!m_ok || len<0 || len>m_end-m_p)
+      {
+        m_ok=false;
+        return QCString();
+      }
+      QCString result(std::string(m_p,static_cast<size_t>(len)));
+      m_p+=len;
+      return result;
+    }
+    void readArgumentList(ArgumentList &al)
+    {
+      int count = readInt();
+      for (int i=0;i<count && m_ok;i++)
+      {
+        Argument a;
+        a.attrib         = readString();
+        a.type           = readString();
+        a.canType        = readString();
+        a.name           = readString();
+        a.array          = readString();
+        a.defval         = readString();
+        a.docs           = readString();
+        a.typeConstraint = readString();
+        al.push_back(a);
+      }
+      al.setConstSpecifier(readBool());
+      al.setVolatileSpecifier(readBool());
+      al.setPureSpecifier(readBool());
+      al.setTrailingReturnType(readString());
+      al.setIsDeleted(readBool());
+      al.setRefQualifier(static_cast<RefQualifierType>(readInt()));
+      al.setNoParameters(readBool());
+    }
+    void readEntry(Entry *e)
+    {
+      e->section              = readInt();
+      e->type                 = readString();
+      e->name                 = readString();
+      e->hasTagInfo           = readBool();
+      e->tagInfoData.tagName  = readString();
+      e->tagInfoData.fileName = readString();
+      e->tagInfoData.anchor   = readString();
+      e->protection           = static_cast<Protection>(readInt());
+      e->mtype                = static_cast<MethodTypes>(readInt());
+      e->spec                 = readUInt64();
+      e->initLines            = readInt();
+      e->stat                 = readBool();
+      e->explicitExternal     = readBool();
+      e->proto                = readBool();
+      e->subGrouping          = readBool();
+      e->callGraph            = readBool();
+      e->callerGraph          = readBool();
+      e->referencedByRelation = readBool();
+      e->referencesRelation   = readBool();
+      e->virt                 = static_cast<Specifier>(readInt());
+      e->args                 = readString();
+      e->bitfields            = readString();
+      readArgumentList(e->argList);
+      int numTArgLists = readInt();
+      for (int i=0;i<numTArgLists && m_ok;i++)
+      {
+        ArgumentList al;
+        readArgumentList(al);
+        e->tArgLists.push_back(al);
+      }
+      e->program.str(readString().str());
+      e->initializer.str(readString().str());
+      e->includeFile          = readString();
+      e->includeName          = readString();
+      e->doc                  = readString();
+      e->docLine              = readInt();
+      e->docFile              = readString();
+      e->brief                = readString();
+      e->briefLine            = readInt();
+      e->briefFile            = readString();
+      e->inbodyDocs           = readString();
+      e->inbodyLine           = readInt();
+      e->inbodyFile           = readString();
+      e->relates              = readString();
+      e->relatesType          = static_cast<RelatesType>(readInt());
+      e->read                 = readString();
+      e->write                = readString();
+      e->inside               = readString();
+      e->exception            = readString();
+      readArgumentList(e->typeConstr);
+      e->bodyLine             = readInt();
+      e->bodyColumn           = readInt();
+      e->endBodyLine          = readInt();
+      int numExtends = readInt();
+      for (int i=0;i<numExtends && m_ok;i++)
+      {
+        QCString name  = readString();
+        Protection prot = static_cast<Protection>(readInt());
+        Specifier virt  = static_cast<Specifier>(readInt());
+        e->extends.push_back(BaseInfo(name,prot,virt));
+      }
+      int numGroups = readInt();
+      for (int i=0;i<numGroups && m_ok;i++)
+      {
+        QCString name = readString();
+        Grouping::GroupPri_t pri = static_cast<Grouping::GroupPri_t>(readInt());
+        e->groups.push_back(Grouping(name,pri));
+      }
+      e->fileName             = readString();
+      e->startLine            = readInt();
+      e->startColumn          = readInt();
+      e->lang                 = static_cast<SrcLangExt>(readInt());
+      e->hidden               = readBool();
+      e->artificial           = readBool();
+      e->groupDocType         = static_cast<Entry::GroupDocType>(readInt());
+      e->id                   = readString();
+      int tocMask             = readInt();
+      int htmlLevel           = readInt();
+      int latexLevel          = readInt();
+      int xmlLevel            = readInt();
+      int docbookLevel        = readInt();
+      if (tocMask & (1<<LocalToc::Html))    e->localToc.enableHtml(htmlLevel);
+      if (tocMask & (1<<LocalToc::Latex))   e->localToc.enableLatex(latexLevel);
+      if (tocMask & (1<<LocalToc::Xml))     e->localToc.enableXml(xmlLevel);
+      if (tocMask & (1<<LocalToc::Docbook)) e->localToc.enableDocbook(docbookLevel);
+      e->metaData             = readString();
+      e->req                  = readString();
+      int numChildren = readInt();
+      for (int i=0;i<numChildren && m_ok;i++)
+      {
+        std::shared_ptr<Entry> child = std::make_shared<Entry>();
+        readEntry(child.get());
+        e->moveToSubEntryAndKeep(child);
+      }
+    }
+  private:
+    void readRaw(void *dst,size_t len)
+    {
+      if (!m_ok || static_cast<size_t>(m_end-m_p)<len)
+      {
+        m_ok=false;
+        return;
+      }
+      memcpy(dst,m_p,len);
+      m_p+=len;
+    }
+    const char *m_p;
+    const char *m_end;
+    bool m_ok = true;
+};
+
+//---------------------------------------------------------------------------
+
+/** Returns true if the Entry tree rooted at \a e refers to items that are
+ *  registered globally while parsing, which cannot be restored from the cache.
+ */
+static bool hasGlobalReferences(const Entry *e)
+{
+  if (!e->anchors.empty() || !e->sli.empty() || e->mGrpId!=-1)
+  {
+    return true;
+  }
+  for (const auto &child : e->children())
+  {
+    if (hasGlobalReferences(child.get())) return true;
+  }
+  return false;
+}
+
+/** Returns a string representing the values of the configuration options that influence parsing */
+static std::string configFingerprint()
+{
+  std::ostringstream t;
+  auto addList = [&t](const StringVector &list)
+  {
+    for (const auto &s : list) t << s << '\x01';
+    t << '\x02';
+  };
+  t << getDoxygenVersion() << '\x02';
+  t << Config_getBool(JAVADOC_AUTOBRIEF)
+    << Config_getBool(JAVADOC_BANNER)
+    << Config_getBool(QT_AUTOBRIEF)
+    << Config_getBool(MULTILINE_CPP_IS_BRIEF)
+    << Config_getBool(PYTHON_DOCSTRING)
+    << Config_getBool(MARKDOWN_SUPPORT)
+    << Config_getBool(AUTOLINK_SUPPORT)
+    << Config_getBool(HIDE_IN_BODY_DOCS)
+    << Config_getBool(INTERNAL_DOCS)
+    << Config_getBool(CALL_GRAPH)
+    << Config_getBool(CALLER_GRAPH)
+    << Config_getBool(REFERENCED_BY_RELATION)
+    << Config_getBool(REFERENCES_RELATION)
+    << Config_getBool(OPTIMIZE_OUTPUT_FOR_C)
+    << Config_getBool(OPTIMIZE_OUTPUT_JAVA)
+    << Config_getBool(OPTIMIZE_FOR_FORTRAN)
+    << Config_getBool(OPTIMIZE_OUTPUT_VHDL)
+    << Config_getBool(OPTIMIZE_OUTPUT_SLICE)
+    << Config_getBool(CPP_CLI_SUPPORT)
+    << Config_getBool(SIP_SUPPORT)
+    << Config_getBool(IDL_PROPERTY_SUPPORT)
+    << Config_getBool(BUILTIN_STL_SUPPORT)
+    << Config_getBool(EXTRACT_PRIVATE)
+    << Config_getBool(EXTRACT_PACKAGE)
+    << Config_getBool(EXTRACT_ANON_NSPACES)
+    << Config_getBool(TYPEDEF_HIDES_STRUCT)
+    << Config_getBool(CASE_SENSE_NAMES)
+    << Config_getBool(ALLOW_UNICODE_NAMES)
+    << Config_getBool(GROUP_NESTED_COMPOUNDS)
+    << Config_getBool(ENABLE_PREPROCESSING)
+    << Config_getBool(MACRO_EXPANSION)
+    << Config_getBool(EXPAND_ONLY_PREDEF)
+    << Config_getBool(SEARCH_INCLUDES)
+    << '\x02';
+  t << Config_getInt(TAB_SIZE) << '\x02';
+  t << Config_getInt(TOC_INCLUDE_HEADINGS) << '\x02';
+  t << Config_getEnumAsString(OUTPUT_LANGUAGE) << '\x02';
+  t << Config_getString(INPUT_FILTER) << '\x02';
+  t << Config_getString(INPUT_ENCODING) << '\x02';
+  t << Config_getString(USE_MDFILE_AS_MAINPAGE) << '\x02';
+  addList(Config_getList(EXTENSION_MAPPING));
+  addList(Config_getList(FILTER_PATTERNS));
+  addList(Config_getList(ALIASES));
+  addList(Config_getList(ENABLED_SECTIONS));
+  addList(Config_getList(STRIP_FROM_PATH));
+  addList(Config_getList(STRIP_FROM_INC_PATH));
+  addList(Config_getList(PREDEFINED));
+  return t.str();
+}
+
+//---------------------------------------------------------------------------
+
+struct EntryCache::Private
+{
+  bool enabled = false;
+  QCString dirName;
+  std::string fingerprint;
+  std::mutex usedKeysMutex;
+  StringUnorderedSet usedKeys;
+  std::atomic_int numHits   { 0 };
+  std::atomic_int numMisses { 0 };
+  std::atomic_int numStored { 0 };
+
+  QCString fileNameForKey(const QCString &key) const
+  {
+    return dirName+"/"+key+g_cacheExt;
+  }
+  void markUsed(const QCString &key)
+  {
+    std::lock_guard<std::mutex> lock(usedKeysMutex);
+    usedKeys.insert(key.str());
+  }
+};
+
+EntryCache::EntryCache() : p(std::make_unique<Private>())
+{
+}
+
+EntryCache::~EntryCache()
+{
+}
+
+EntryCache &EntryCache::instance()
+{
+  static EntryCache ec;
+  return ec;
+}
+
+void EntryCache::initialize()
+{
+  p->enabled = Config_getBool(PARSE_CACHE);
+  if (!p->enabled) return;
+
+  QCString outputDirectory = Config_getString(OUTPUT_DIRECTORY);
+  QCString dirName = Config_getString(PARSE_CACHE_DIR);
+  if (dirName.isEmpty())
+  {
+    dirName = outputDirectory+"/parsecache";
+  }
+  else if (Dir::isRelativePath(dirName.str()))
+  {
+    dirName.prepend(outputDirectory+"/");
+  }
+  Dir dir(dirName.str());
+  if (!dir.exists() && !dir.mkdir(dirName.str()))
+  {
+    warn_uncond("Could not create parse cache directory %s, parse cache is disabled\n",qPrint(dirName));
+    p->enabled = false;
+    return;
+  }
+  p->dirName = dir.absPath();
+  p->fingerprint = configFingerprint();
+}
+
+bool EntryCache::isEnabled() const
+{
+  return p->enabled;
+}
+
+QCString EntryCache::key(const QCString &fileName,const BufStr &input) const
+{
+  if (!p->enabled) return QCString();
+  MD5Context ctx;
+  MD5Init(&ctx);
+  MD5Update(&ctx,reinterpret_cast<const unsigned char *>(p->fingerprint.data()),static_cast<unsigned>(p->fingerprint.length()));
+  MD5Update(&ctx,reinterpret_cast<const unsigned char *>(fileName.data()),static_cast<unsigned>(fileName.length()+1));
+  MD5Update(&ctx,reinterpret_cast<const unsigned char *>(input.data()),static_cast<unsigned>(input.curPos()));
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Final(md5_sig,&ctx);
+  MD5SigToString(md5_sig,sigStr);
+  return sigStr;
+}
+
+std::shared_ptr<Entry> EntryCache::load(const QCString &key)
+{
+  if (!p->enabled || key.isEmpty()) return nullptr;
+
+  std::ifstream f(p->fileNameForKey(key).str(),std::ifstream::in | std::ifstream::binary);
+  if (!f.is_open())
+  {
+    p->numMisses++;
+    return nullptr;
+  }
+  std::string data((std::istreambuf_iterator<char>(f)),std::istreambuf_iterator<char>());
+  EntryReader reader(data);
+  std::shared_ptr<Entry> root;
+  if (reader.readString()==g_cacheMagic && reader.readInt()==g_cacheVersion)
+  {
+    root = std::make_shared<Entry>();
+    reader.readEntry(root.get());
+  }
+  if (!reader.isValid() || !reader.atEnd() || !root)
+  {
+    // corrupt or outdated entry, it will be overwritten after parsing
+    p->numMisses++;
+    return nullptr;
+  }
+  p->markUsed(key);
+  p->numHits++;
+  return root;
+}
+
+void EntryCache::beginParse()
+{
+  g_parseHasSideEffects = false;
+}
+
+void EntryCache::markUncacheable()
+{
+  g_parseHasSideEffects = true;
+}
+
+void EntryCache::store(const QCString &key,const Entry *root)
+{
+  if (!p->enabled || key.isEmpty()) return;
+  if (g_parseHasSideEffects || hasGlobalReferences(root)) return;
+
+  // write to a temporary file first and then move it into place, so an
+  // interrupted run never leaves a partially written entry behind
+  std::ostringstream tmpSuffix;
+  tmpSuffix << ".tmp" << std::this_thread::get_id();
+  QCString fileName = p->fileNameForKey(key);
+  QCString tmpFileName = fileName+tmpSuffix.str().c_str();
+  {
+    std::ofstream f(tmpFileName.str(),std::ofstream::out | std::ofstream::binary);
+    if (!f.is_open())
+    {
+      return;
+    }
+    EntryWriter writer(f);
+    writer.writeString(QCString(g_cacheMagic));
+    writer.writeInt(g_cacheVersion);
+    writer.writeEntry(root);
+    if (!f.good())
+    {
+      f.close();
+      Dir().remove(tmpFileName.str());
+      return;
+    }
+  }
+  Dir dir;
+  dir.remove(fileName.str());
+  if (dir.rename(tmpFileName.str(),fileName.str()))
+  {
+    p->markUsed(key);
+    p->numStored++;
+  }
+  else
+  {
+    dir.remove(tmpFileName.str());
+  }
+}
+
+void EntryCache::finish()
+{
+  if (!p->enabled) return;
+
+  // remove the entries that belong to files that were removed or changed
+  Dir dir(p->dirName.str());
+  StringVector obsolete;
+  for (const auto &dirEntry : dir.iterator())
+  {
+    if (dirEntry.is_regular_file())
+    {
+      FileInfo fi(dirEntry.path());
+      QCString name = fi.fileName();
+      if (name.endsWith(g_cacheExt))
+      {
+        QCString key = name.left(name.length()-qstrlen(g_cacheExt));
+        if (p->usedKeys.find(key.str())==p->usedKeys.end())
+        {
+          obsolete.push_back(dirEntry.path());
+        }
+      }
+    }
+  }
+  for (const auto &path : obsolete)
+  {
+    dir.remove(path);
+  }
+  msg("Parse cache: %d file(s) reused, %d file(s) parsed, %d result(s) stored, %zu obsolete result(s) removed\n",
+      p->numHits.load(),p->numMisses.load(),p->numStored.load(),obsolete.size());
+}
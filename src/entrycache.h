@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef ENTRYCACHE_H
+#define ENTRYCACHE_H
+
+#include <memory>
+
+#include "qcstring.h"
+
+class Entry;
+class BufStr;
+
+/** @brief Persistent on-disk cache for the Entry trees produced by the outline parsers.
+ *
+ *  The cache key of a file is an MD5 digest of the file name, the
+ *  preprocessed input as passed to the parser, and the configuration
+ *  options that influence parsing. Macro definitions coming from included
+ *  files are therefore automatically taken into account.
+ *
+ *  A parse result is only stored if parsing the file did not have any side
+ *  effects outside of the resulting Entry tree (see markUncacheable()).
+ *  Only the thread that parses a file uses its key, so load() and
+ *  store() can be called concurrently from multiple threads.
+ */
+class EntryCache
+{
+  public:
+    static EntryCache &instance();
+
+    /** Reads the configuration and prepares the cache directory. */
+    void initialize();
+
+    /** Removes the entries that were not used during this run and reports statistics. */
+    void finish();
+
+    bool isEnabled() const;
+
+    /** Returns the cache key for file \a fileName with parser input \a input,
+     *  or an empty string if the cache is disabled.
+     */
+    QCString key(const QCString &fileName,const BufStr &input) const;
+
+    /** Returns the cached Entry tree for \a key, or a null pointer if there is none. */
+    std::shared_ptr<Entry> load(const QCString &key);
+
+    /** Marks the start of parsing a file on the current thread. */
+    void beginParse();
+
+    /** Stores the Entry tree \a root under \a key, unless the parse
+     *  that started with beginParse() had side effects.
+     */
+    void store(const QCString &key,const Entry *root);
+
+    /** Marks the parse running on the current thread as having
+     *  side effects, so its result will not be stored.
+     */
+    static void markUncacheable();
+
+  private:
+    EntryCache();
+   ~EntryCache();
+    EntryCache(const EntryCache &) = delete;
+    EntryCache &operator=(const EntryCache &) = delete;
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
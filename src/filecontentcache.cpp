@@ -0,0 +1,180 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "filecontentcache.h"
+#include "fileinfo.h"
+#include "config.h"
+
+namespace
+{
+
+struct CacheEntry
+{
+  size_t   fileSize;
+  uint64_t lastModified;
+  uint64_t id;          // distinguishes an entry from a later entry with the same key
+  std::shared_future<FileContentCache::Contents> contents;
+  size_t   memSize;     // 0 as long as the contents are being read
+  std::list<std::string>::iterator lruPos;
+};
+
+} // namespace
+
+struct FileContentCache::Private
+{
+  mutable std::mutex mutex;
+  std::unordered_map<std::string,CacheEntry> entries;
+  std::list<std::string> lru; // keys, most recently used first
+  size_t   totalSize = 0;
+  uint64_t nextId = 0;
+  std::atomic<uint64_t> hits   { 0 };
+  std::atomic<uint64_t> misses { 0 };
+
+  void remove(std::unordered_map<std::string,CacheEntry>::iterator it)
+  {
+    totalSize-=it->second.memSize;
+    lru.erase(it->second.lruPos);
+    entries.erase(it);
+  }
+  void evict(size_t maxSize)
+  {
+    while (totalSize>maxSize && !lru.empty())
+    {
+      remove(entries.find(lru.back()));
+    }
+  }
+};
+
+FileContents::FileContents(std::string &&s) : m_string(std::move(s))
+{
+}
+
+void FileContents::skip(size_t n)
+{
+  m_offset = std::min(m_offset+n,m_string.size());
+}
+
+//---------------------------------------------------------------------------
+
+FileContentCache::FileContentCache() : p(std::make_unique<Private>())
+{
+}
+
+FileContentCache::~FileContentCache()
+{
+}
+
+FileContentCache &FileContentCache::instance()
+{
+  static FileContentCache cache;
+  return cache;
+}
+
+FileContentCache::Contents FileContentCache::get(const FileInfo &fi,const QCString &filterName,const Reader &reader)
+{
+  size_t maxSize = static_cast<size_t>(Config_getInt(INPUT_CACHE_MEMORY))*1024*1024;
+  if (maxSize==0) // cache disabled
+  {
+    return reader();
+  }
+
+  std::string key = fi.absFilePath()+"\n"+filterName.str();
+  size_t fileSize = fi.size();
+  uint64_t lastModified = fi.lastModified();
+  std::promise<Contents> promise;
+  std::shared_future<Contents> future;
+  uint64_t id = 0;
+  {
+    std::lock_guard<std::mutex> lock(p->mutex);
+    auto it = p->entries.find(key);
+    if (it!=p->entries.end() &&
+        it->second.fileSize==fileSize && it->second.lastModified==lastModified)
+    {
+      p->hits++;
+      p->lru.splice(p->lru.begin(),p->lru,it->second.lruPos);
+      future = it->second.contents;
+    }
+    else
+    {
+      if (it!=p->entries.end()) // file changed since it was cached
+      {
+        p->remove(it);
+      }
+      p->misses++;
+      id = ++p->nextId;
+      future = promise.get_future().share();
+      p->lru.push_front(key);
+      p->entries.insert(std::make_pair(key,
+            CacheEntry{ fileSize, lastModified, id, future, 0, p->lru.begin() }));
+    }
+  }
+  if (id==0) // hit, possibly still being read by another thread
+  {
+    return future.get();
+  }
+
+  // miss: this thread reads the file
+  Contents result = reader();
+  promise.set_value(result);
+  {
+    std::lock_guard<std::mutex> lock(p->mutex);
+    auto it = p->entries.find(key);
+    if (it!=p->entries.end() && it->second.id==id)
+    {
+      if (result)
+      {
+        it->second.memSize = result->size()+key.size();
+        p->totalSize+=it->second.memSize;
+        p->evict(maxSize);
+      }
+      else // do not keep failures, so the error is reported again next time
+      {
+        p->remove(it);
+      }
+    }
+  }
+  return result;
+}
+
+void FileContentCache::clear()
+{
+  std::lock_guard<std::mutex> lock(p->mutex);
+  p->entries.clear();
+  p->lru.clear();
+  p->totalSize = 0;
+}
+
+uint64_t FileContentCache::hits() const
+{
+  return p->hits;
+}
+
+uint64_t FileContentCache::misses() const
+{
+  return p->misses;
+}
+
+size_t FileContentCache::size() const
+{
+  std::lock_guard<std::mutex> lock(p->mutex);
+  return p->totalSize;
+}
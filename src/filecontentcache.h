@@ -0,0 +1,91 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef FILECONTENTCACHE_H
+#define FILECONTENTCACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "qcstring.h"
+
+class FileInfo;
+
+/** @brief Read-only view on the contents of a file. */
+class FileContents
+{
+  public:
+    explicit FileContents(std::string &&s);
+    FileContents(const FileContents &) = delete;
+    FileContents &operator=(const FileContents &) = delete;
+
+    const char *data() const { return m_string.data()+m_offset; }
+    size_t size() const      { return m_string.size()-m_offset; }
+
+    /** Removes the first \a n bytes from the view. */
+    void skip(size_t n);
+
+  private:
+    std::string m_string;
+    size_t      m_offset = 0;
+};
+
+/** @brief Thread-safe, size bounded in-memory cache for the contents of input files.
+ *
+ *  An input file is read for parsing, for its source listing and for code
+ *  fragments. The cache keeps the result of reading, filtering and
+ *  transcoding a file, so the (possibly expensive) input filter runs only
+ *  once per file. The key of an entry is the file name plus the filter that was
+ *  applied. Entries are validated against the size and modification
+ *  time of the file. When the memory limit set with \c INPUT_CACHE_MEMORY is
+ *  exceeded the least recently used entries are dropped.
+ *
+ *  If multiple threads ask for the same file at the same time the
+ *  file is read by one of them and the others wait for the result.
+ */
+class FileContentCache
+{
+  public:
+    using Contents = std::shared_ptr<const FileContents>;
+    using Reader   = std::function<Contents()>;
+
+    static FileContentCache &instance();
+
+    /** Returns the contents of file \a fi as processed with \a filterName.
+     *  On a cache miss \a reader is called to produce the contents, it
+     *  returns a null pointer on failure.
+     */
+    Contents get(const FileInfo &fi,const QCString &filterName,const Reader &reader);
+
+    /** Removes all entries from the cache. */
+    void clear();
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+    /** Returns the number of bytes currently stored in the cache. */
+    size_t size() const;
+
+  private:
+    FileContentCache();
+   ~FileContentCache();
+    FileContentCache(const FileContentCache &) = delete;
+    FileContentCache &operator=(const FileContentCache &) = delete;
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
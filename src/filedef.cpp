@@ -46,6 +46,7 @@
 #include "settings.h"
 #include "definitionimpl.h"
 #include "conceptdef.h"
+#include "profiler.h"
 
 //---------------------------------------------------------------------------
 
@@ -1133,6 +1134,7 @@ void FileDefImpl::writeSourceHeader(OutputList &ol)
 
 void FileDefImpl::writeSourceBody(OutputList &ol,ClangTUParser *clangParser)
 {
+  ProfileScope profile("write source",name());
   bool filterSourceFiles = Config_getBool(FILTER_SOURCE_FILES);
   DevNullCodeDocInterface devNullIntf;
 #if USE_LIBCLANG
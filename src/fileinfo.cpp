@@ -27,6 +27,22 @@ size_t FileInfo::size() const
   return ec ? 0 : result;
 }
 
+uint64_t FileInfo::lastModified() const
+{
+  std::error_code ec;
+  fs::file_time_type t = fs::last_write_time(fs::path(m_name),ec);
+  return ec ? 0 : static_cast<uint64_t>(t.time_since_epoch().count());
+}
+
+uint64_t FileInfo::secondsSinceModified() const
+{
+  std::error_code ec;
+  fs::file_time_type t = fs::last_write_time(fs::path(m_name),ec);
+  if (ec) return 0;
+  auto age = std::chrono::duration_cast<std::chrono::seconds>(fs::file_time_type::clock::now()-t);
+  return age.count()>0 ? static_cast<uint64_t>(age.count()) : 0;
+}
+
 bool FileInfo::exists() const
 {
   std::error_code ec;
@@ -16,6 +16,7 @@
 #ifndef FILEINFO_H
 #define FILEINFO_H
 
+#include <cstdint>
 #include <string>
 
 /** @brief Minimal replacement for QFileInfo. */
@@ -25,6 +26,10 @@ class FileInfo
     explicit FileInfo(const std::string &name) : m_name(name) {}
     bool exists() const;
     size_t size() const;
+    /** Returns the time of the last modification in file system ticks, suitable for comparisons only. */
+    uint64_t lastModified() const;
+    /** Returns the number of seconds since the last modification. */
+    uint64_t secondsSinceModified() const;
     bool isWritable() const;
     bool isReadable() const;
     bool isExecutable() const;
@@ -0,0 +1,292 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "filtercache.h"
+#include "config.h"
+#include "message.h"
+#include "containers.h"
+#include "fileinfo.h"
+#include "dir.h"
+#include "md5.h"
+#include "portable.h"
+#include "util.h"
+
+static const char *g_cacheExt = ".filtered";
+static const char *g_tmpExt   = ".filtered.tmp";
+
+// in a shared directory an entry is kept until no run used it for this long
+static const uint64_t g_maxUnusedAge = 30*24*60*60;
+// a temporary file this old was left behind by an interrupted run
+static const uint64_t g_maxTmpAge    = 60*60;
+
+struct FilterCache::Private
+{
+  bool enabled = false;
+  bool sharedDir = false; // FILTER_CACHE_DIR may be used by other projects as well
+  QCString dirName;
+  std::mutex mutex;
+  StringUnorderedSet usedKeys;
+  std::unordered_map<std::string,std::string> programStamps; // filter command -> stamp
+  std::atomic_int numHits   { 0 };
+  std::atomic_int numMisses { 0 };
+
+  QCString fileNameForKey(const QCString &key) const
+  {
+    return dirName+"/"+key+g_cacheExt;
+  }
+  void markUsed(const QCString &key)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    usedKeys.insert(key.str());
+  }
+  std::string programStamp(const QCString &filterName);
+};
+
+//! returns the path of \a program, searching the PATH if it does not name an existing file
+static std::string findProgram(const std::string &program)
+{
+  if (FileInfo(program).isFile()) return program;
+  if (program.find_first_of("/\\")!=std::string::npos) return std::string();
+  QCString paths = Portable::getenv("PATH");
+  char listSep = Portable::pathListSeparator()[0];
+  for (const auto &dir : split(paths.str(),std::string(1,listSep)))
+  {
+    std::string path = dir+Portable::pathSeparator().str()+program;
+    if (FileInfo(path).isFile()) return path;
+    path+=Portable::commandExtension();
+    if (FileInfo(path).isFile()) return path;
+  }
+  return std::string();
+}
+
+/** Returns a string describing the modification times of the programs and
+ *  scripts that are named in \a filterName, so changing the filter
+ *  invalidates its cached output.
+ */
+std::string FilterCache::Private::programStamp(const QCString &filterName)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = programStamps.find(filterName.str());
+  if (it!=programStamps.end()) return it->second;
+
+  std::string stamp;
+  bool first = true;
+  for (auto arg : split(filterName.str()," "))
+  {
+    if (arg.size()>=2 && arg.front()=='"' && arg.back()=='"')
+    {
+      arg = arg.substr(1,arg.size()-2);
+    }
+    // the first word is the program, the others may name the script it runs
+    std::string path = first ? findProgram(arg) : (FileInfo(arg).isFile() ? arg : std::string());
+    first = false;
+    if (!path.empty())
+    {
+      FileInfo fi(path);
+      stamp+=fi.absFilePath()+"@"+std::to_string(fi.lastModified())+"\n";
+    }
+  }
+  programStamps.insert(std::make_pair(filterName.str(),stamp));
+  return stamp;
+}
+
+FilterCache::FilterCache() : p(std::make_unique<Private>())
+{
+}
+
+FilterCache::~FilterCache()
+{
+}
+
+FilterCache &FilterCache::instance()
+{
+  static FilterCache fc;
+  return fc;
+}
+
+void FilterCache::initialize()
+{
+  p->enabled = Config_getBool(FILTER_CACHE);
+  if (!p->enabled) return;
+
+  QCString outputDirectory = Config_getString(OUTPUT_DIRECTORY);
+  QCString dirName = Config_getString(FILTER_CACHE_DIR);
+  p->sharedDir = !dirName.isEmpty();
+  if (dirName.isEmpty())
+  {
+    dirName = outputDirectory+"/filtercache";
+  }
+  else if (Dir::isRelativePath(dirName.str()))
+  {
+    dirName.prepend(outputDirectory+"/");
+  }
+  Dir dir(dirName.str());
+  if (!dir.exists() && !dir.mkdir(dirName.str()))
+  {
+    warn_uncond("Could not create filter cache directory %s, filter cache is disabled\n",qPrint(dirName));
+    p->enabled = false;
+    return;
+  }
+  p->dirName = dir.absPath();
+}
+
+void FilterCache::finish()
+{
+  if (!p->enabled) return;
+
+  // remove the entries for files or filters that were removed or changed. A shared
+  // directory also holds the entries of other projects, so there only the entries
+  // that were not used for a long time are removed.
+  Dir dir(p->dirName.str());
+  StringVector obsolete;
+  {
+    std::lock_guard<std::mutex> lock(p->mutex);
+    for (const auto &dirEntry : dir.iterator())
+    {
+      if (dirEntry.is_regular_file())
+      {
+        FileInfo fi(dirEntry.path());
+        QCString name = fi.fileName();
+        if (name.endsWith(g_cacheExt))
+        {
+          QCString key = name.left(name.length()-qstrlen(g_cacheExt));
+          if (p->usedKeys.find(key.str())==p->usedKeys.end() &&
+              (!p->sharedDir || fi.secondsSinceModified()>g_maxUnusedAge))
+          {
+            obsolete.push_back(dirEntry.path());
+          }
+        }
+        else if (name.find(g_tmpExt)!=-1 && fi.secondsSinceModified()>g_maxTmpAge)
+        {
+          obsolete.push_back(dirEntry.path());
+        }
+      }
+    }
+  }
+  for (const auto &path : obsolete)
+  {
+    dir.remove(path);
+  }
+  msg("Filter cache: %d file(s) reused, %d file(s) filtered, %zu obsolete result(s) removed\n",
+      p->numHits.load(),p->numMisses.load(),obsolete.size());
+}
+
+bool FilterCache::isEnabled() const
+{
+  return p->enabled;
+}
+
+QCString FilterCache::key(const QCString &filterName,const QCString &fileName)
+{
+  if (!p->enabled) return QCString();
+  std::ifstream f(fileName.str(),std::ifstream::in | std::ifstream::binary);
+  if (!f.is_open()) return QCString();
+
+  std::string stamp = p->programStamp(filterName);
+  MD5Context ctx;
+  MD5Init(&ctx);
+  MD5Update(&ctx,reinterpret_cast<const unsigned char *>(filterName.data()),static_cast<unsigned>(filterName.length()+1));
+  MD5Update(&ctx,reinterpret_cast<const unsigned char *>(stamp.data()),static_cast<unsigned>(stamp.length()+1));
+  MD5Update(&ctx,reinterpret_cast<const unsigned char *>(fileName.data()),static_cast<unsigned>(fileName.length()+1));
+  const int blockSize = 65536;
+  char buf[blockSize];
+  while (f)
+  {
+    f.read(buf,blockSize);
+    MD5Update(&ctx,reinterpret_cast<const unsigned char *>(buf),static_cast<unsigned>(f.gcount()));
+  }
+  if (f.bad()) return QCString();
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Final(md5_sig,&ctx);
+  MD5SigToString(md5_sig,sigStr);
+  return sigStr;
+}
+
+bool FilterCache::load(const QCString &key,std::string &output)
+{
+  if (!p->enabled || key.isEmpty()) return FALSE;
+
+  QCString fileName = p->fileNameForKey(key);
+  FileInfo fi(fileName.str());
+  std::ifstream f(fileName.str(),std::ifstream::in | std::ifstream::binary);
+  if (!f.is_open())
+  {
+    p->numMisses++;
+    return FALSE;
+  }
+  size_t pos = output.size();
+  size_t size = fi.size();
+  output.resize(pos+size);
+  f.read(&output[pos],static_cast<std::streamsize>(size));
+  if (static_cast<size_t>(f.gcount())!=size)
+  {
+    // truncated entry, it will be overwritten after filtering
+    output.resize(pos);
+    p->numMisses++;
+    return FALSE;
+  }
+  if (p->sharedDir)
+  {
+    Dir().touch(fileName.str()); // the modification time tells when the entry was last used
+  }
+  p->markUsed(key);
+  p->numHits++;
+  return TRUE;
+}
+
+void FilterCache::store(const QCString &key,const char *data,size_t size)
+{
+  if (!p->enabled || key.isEmpty()) return;
+
+  // write to a temporary file first and then move it into place, so an
+  // interrupted run never leaves a partially written entry behind. The name
+  // is unique per process and thread, since the directory may be shared by runs.
+  std::ostringstream tmpSuffix;
+  tmpSuffix << ".tmp" << Portable::pid() << "_" << std::this_thread::get_id();
+  QCString fileName = p->fileNameForKey(key);
+  QCString tmpFileName = fileName+tmpSuffix.str().c_str();
+  {
+    std::ofstream f(tmpFileName.str(),std::ofstream::out | std::ofstream::binary);
+    if (!f.is_open())
+    {
+      return;
+    }
+    f.write(data,static_cast<std::streamsize>(size));
+    if (!f.good())
+    {
+      f.close();
+      Dir().remove(tmpFileName.str());
+      return;
+    }
+  }
+  Dir dir;
+  dir.remove(fileName.str());
+  if (dir.rename(tmpFileName.str(),fileName.str()))
+  {
+    p->markUsed(key);
+  }
+  else
+  {
+    dir.remove(tmpFileName.str());
+  }
+}
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef FILTERCACHE_H
+#define FILTERCACHE_H
+
+#include <memory>
+#include <string>
+
+#include "qcstring.h"
+
+/** @brief Persistent on-disk cache for the output of input filters.
+ *
+ *  The output of running a filter on a file is stored in the directory set
+ *  with \c FILTER_CACHE_DIR under the MD5 digest of the filter command,
+ *  the modification times of the programs and scripts named in the command,
+ *  the name of the file and its contents. On a next run the filter is only
+ *  executed for files for which one of these changed.
+ *
+ *  All methods can be called concurrently from multiple threads.
+ */
+class FilterCache
+{
+  public:
+    static FilterCache &instance();
+
+    /** Reads the configuration and prepares the cache directory. */
+    void initialize();
+
+    /** Removes obsolete entries and files left by interrupted runs, and reports statistics.
+     *  In a directory shared with other projects only entries unused for a long time are obsolete.
+     */
+    void finish();
+
+    bool isEnabled() const;
+
+    /** Returns the cache key for filtering file \a fileName with \a filterName,
+     *  or an empty string if the cache is disabled or the file cannot be read.
+     */
+    QCString key(const QCString &filterName,const QCString &fileName);
+
+    /** Appends the filter output stored under \a key to \a output.
+     *  Returns FALSE if there is no such entry.
+     */
+    bool load(const QCString &key,std::string &output);
+
+    /** Stores the \a size bytes of filter output at \a data under \a key. */
+    void store(const QCString &key,const char *data,size_t size);
+
+  private:
+    FilterCache();
+   ~FilterCache();
+    FilterCache(const FilterCache &) = delete;
+    FilterCache &operator=(const FilterCache &) = delete;
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
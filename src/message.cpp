@@ -20,17 +20,223 @@
 #include "message.h"
 #include "doxygen.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
 
 // globals
 static QCString        g_warnFormat;
 static const char *    g_warningStr = "warning: ";
 static const char *    g_errorStr = "error: ";
 static FILE *          g_warnFile = stderr;
+static FILE *          g_jsonFile = 0;
 static WARN_AS_ERROR_t g_warnBehavior = WARN_AS_ERROR_t::NO;
-static bool            g_warnStat = false;
+static std::atomic<bool> g_warnStat { false };
 static std::mutex      g_mutex;
 
+//------------------------------------------------------------------------
+// Asynchronous message sink
+//
+// Warnings and errors are formatted on the calling thread and pushed on a
+// lock-free list. A background thread takes the whole list at once and writes
+// the messages in the order they were pushed, so threads producing warnings
+// do not wait for each other or for the output. Progress messages (msg()) are
+// written directly, so they stay ordered with the output of Debug::print().
+
+namespace
+{
+
+struct LogEntry
+{
+  LogEntry   *next = 0;
+  FILE       *file = 0;
+  std::string text;
+  std::string json;       // line for the JSON warning log, empty if none
+  bool        isWarning = false;
+};
+
+class MessageSink
+{
+  public:
+    MessageSink(bool deduplicate) : m_deduplicate(deduplicate)
+    {
+      std::thread(&MessageSink::run,this).detach();
+    }
+
+    // adds a message, can be called from any thread
+    void push(LogEntry *entry)
+    {
+      LogEntry *head = m_head.load(std::memory_order_relaxed);
+      do
+      {
+        entry->next = head;
+      }
+      while (!m_head.compare_exchange_weak(head,entry,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+      if (head==0) // writer may be sleeping, wake it up
+      {
+        { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+        m_wakeCond.notify_one();
+      }
+    }
+
+    // writes all pending messages, returns when done
+    void flush()
+    {
+      std::lock_guard<std::mutex> lock(m_writeMutex);
+      write();
+      fflush(stdout);
+      fflush(g_warnFile);
+      if (g_jsonFile) fflush(g_jsonFile);
+    }
+
+  private:
+    void run()
+    {
+      for (;;)
+      {
+        {
+          std::unique_lock<std::mutex> lock(m_wakeMutex);
+          m_wakeCond.wait(lock,[this]() { return m_head.load(std::memory_order_relaxed)!=0; });
+        }
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        write();
+      }
+    }
+
+    // writes the pending messages, m_writeMutex must be locked
+    void write()
+    {
+      // take all messages, they are in reverse order
+      LogEntry *list = m_head.exchange(0,std::memory_order_acquire);
+      LogEntry *ordered = 0;
+      while (list)
+      {
+        LogEntry *next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+      }
+      while (ordered)
+      {
+        std::unique_ptr<LogEntry> entry(ordered);
+        ordered = ordered->next;
+        if (entry->isWarning && m_deduplicate && !m_seen.insert(entry->text).second)
+        {
+          continue; // identical warning was already reported
+        }
+        fwrite(entry->text.data(),1,entry->text.length(),entry->file);
+        if (g_jsonFile && !entry->json.empty())
+        {
+          fwrite(entry->json.data(),1,entry->json.length(),g_jsonFile);
+        }
+      }
+    }
+
+    bool m_deduplicate;
+    std::atomic<LogEntry*> m_head { 0 };
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCond;
+    std::mutex m_writeMutex;
+    std::unordered_set<std::string> m_seen;
+};
+
+// created once and never deleted, as the writer thread may still run during exit
+MessageSink *g_sink = 0;
+
+void flushMessages()
+{
+  if (g_sink) g_sink->flush();
+}
+
+// writes text to file, via the message sink once it is started
+void writeMessage(FILE *file,std::string &&text,std::string &&json=std::string(),bool isWarning=false)
+{
+  if (g_sink)
+  {
+    auto entry = std::make_unique<LogEntry>();
+    entry->file = file;
+    entry->text = std::move(text);
+    entry->json = std::move(json);
+    entry->isWarning = isWarning;
+    g_sink->push(entry.release());
+  }
+  else
+  {
+    std::unique_lock<std::mutex> lock(g_mutex);
+    fwrite(text.data(),1,text.length(),file);
+    if (g_jsonFile && !json.empty())
+    {
+      fwrite(json.data(),1,json.length(),g_jsonFile);
+    }
+  }
+}
+
+std::string vformat(const char *fmt,va_list args)
+{
+  va_list argsCopy;
+  va_copy(argsCopy, args);
+  int len = vsnprintf(NULL, 0, fmt, args);
+  std::string result(len>0 ? static_cast<size_t>(len) : 0,'\0');
+  if (len>0)
+  {
+    vsnprintf(&result[0], static_cast<size_t>(len)+1, fmt, argsCopy);
+  }
+  va_end(argsCopy);
+  return result;
+}
+
+std::string jsonString(const QCString &s)
+{
+  static const char hex[] = "0123456789abcdef";
+  std::string result = "\"";
+  for (uint i=0;i<s.length();i++)
+  {
+    unsigned char c = static_cast<unsigned char>(s.at(i));
+    switch (c)
+    {
+      case '"':  result+="\\\""; break;
+      case '\\': result+="\\\\"; break;
+      case '\n': result+="\\n";  break;
+      case '\t': result+="\\t";  break;
+      default:
+        if (c<0x20)
+        {
+          result+="\\u00";
+          result+=hex[c>>4];
+          result+=hex[c&0xF];
+        }
+        else
+        {
+          result+=static_cast<char>(c);
+        }
+        break;
+    }
+  }
+  result+="\"";
+  return result;
+}
+
+// returns a line of the JSON warning log, or an empty string if there is no such log
+std::string jsonMessage(const QCString &file,int line,const char *prefix,const QCString &text)
+{
+  if (g_jsonFile==0) return std::string();
+  QCString type = QCString(prefix).stripWhiteSpace();
+  if (type.endsWith(":")) type = type.left(type.length()-1);
+  return "{\"file\":"+jsonString(file)+
+         ",\"line\":"+std::to_string(line)+
+         ",\"type\":"+jsonString(type)+
+         ",\"message\":"+jsonString(text.stripWhiteSpace())+"}\n";
+}
+
+} // namespace
+
 void initWarningFormat()
 {
   g_warnFormat = Config_getString(WARN_FORMAT);
@@ -42,11 +248,25 @@ void initWarningFormat()
   {
     g_warnFile = stderr;
   }
+  if (!Config_getString(WARN_JSON_LOGFILE).isEmpty())
+  {
+    g_jsonFile = Portable::fopen(Config_getString(WARN_JSON_LOGFILE).data(),"w");
+    if (!g_jsonFile)
+    {
+      err("Cannot open file %s for writing!\n",qPrint(Config_getString(WARN_JSON_LOGFILE)));
+    }
+  }
   g_warnBehavior = Config_getEnum(WARN_AS_ERROR);
   if (g_warnBehavior != WARN_AS_ERROR_t::NO)
   {
     g_warningStr = g_errorStr;
   }
+  if (!g_sink)
+  {
+    g_sink = new MessageSink(Config_getBool(WARN_NO_DUPLICATES));
+    // also write the pending messages when exit() is called
+    std::atexit(flushMessages);
+  }
 }
 
 
@@ -54,23 +274,27 @@ void msg(const char *fmt, ...)
 {
   if (!Config_getBool(QUIET))
   {
-    std::unique_lock<std::mutex> lock(g_mutex);
+    std::string text;
     if (Debug::isFlagSet(Debug::Time))
     {
-      printf("%.3f sec: ",((double)Debug::elapsedTime()));
+      char time[32];
+      snprintf(time,sizeof(time),"%.3f sec: ",((double)Debug::elapsedTime()));
+      text = time;
     }
     va_list args;
     va_start(args, fmt);
-    vfprintf(stdout, fmt, args);
+    text += vformat(fmt, args);
     va_end(args);
+    std::unique_lock<std::mutex> lock(g_mutex);
+    fwrite(text.data(),1,text.length(),stdout);
   }
 }
 
-static void format_warn(const QCString &file,int line,const QCString &text)
+static void format_warn(const QCString &file,int line,const char *prefix,const QCString &text)
 {
   QCString fileSubst = file.isEmpty() ? "<unknown>" : file;
   QCString lineSubst; lineSubst.setNum(line);
-  QCString textSubst = text;
+  QCString textSubst = QCString(prefix) + text;
   QCString versionSubst;
   // substitute markers by actual values
   QCString msgText =
@@ -93,13 +317,11 @@ static void format_warn(const QCString &file,int line,const QCString &text)
   }
   msgText += '\n';
 
-  {
-    std::unique_lock<std::mutex> lock(g_mutex);
-    // print resulting message
-    fwrite(msgText.data(),1,msgText.length(),g_warnFile);
-  }
+  // print resulting message
+  writeMessage(g_warnFile,msgText.str(),jsonMessage(file,line,prefix,text),true);
   if (g_warnBehavior == WARN_AS_ERROR_t::YES)
   {
+    flushMessages();
     exit(1);
   }
   g_warnStat = true;
@@ -109,11 +331,8 @@ static void handle_warn_as_error()
 {
   if (g_warnBehavior == WARN_AS_ERROR_t::YES)
   {
-    {
-      std::unique_lock<std::mutex> lock(g_mutex);
-      QCString msgText = " (warning treated as error, aborting now)\n";
-      fwrite(msgText.data(),1,msgText.length(),g_warnFile);
-    }
+    writeMessage(g_warnFile," (warning treated as error, aborting now)\n");
+    flushMessages();
     exit(1);
   }
   g_warnStat = true;
@@ -123,29 +342,7 @@ static void do_warn(bool enabled, const QCString &file, int line, const char *pr
 {
   if (!enabled) return; // warning type disabled
 
-  va_list argsCopy;
-  va_copy(argsCopy, args);
-
-  int l=0;
-  if (prefix)
-  {
-    l=(int)strlen(prefix);
-  }
-  // determine needed buffersize based on:
-  // format + arguments
-  // prefix
-  // 1 position for `\0`
-  int bufSize = vsnprintf(NULL, 0, fmt, args) + l + 1;
-  QCString text(bufSize);
-  if (prefix)
-  {
-    qstrncpy(text.rawData(),prefix,bufSize);
-  }
-  vsnprintf(text.rawData()+l, bufSize-l, fmt, argsCopy);
-  text[bufSize-1]='\0';
-  format_warn(file,line,text);
-
-  va_end(argsCopy);
+  format_warn(file,line,prefix,vformat(fmt, args));
 }
 
 void warn(const QCString &file,int line,const char *fmt, ...)
@@ -164,7 +361,7 @@ void va_warn(const QCString &file,int line,const char *fmt,va_list args)
 void warn_simple(const QCString &file,int line,const char *text)
 {
   if (!Config_getBool(WARNINGS)) return; // warning type disabled
-  format_warn(file,line,QCString(g_warningStr) + text);
+  format_warn(file,line,g_warningStr,text);
 }
 
 void warn_undoc(const QCString &file,int line,const char *fmt, ...)
@@ -195,8 +392,9 @@ void warn_uncond(const char *fmt, ...)
 {
   va_list args;
   va_start(args, fmt);
-  vfprintf(g_warnFile, (QCString(g_warningStr) + fmt).data(), args);
+  QCString text = vformat(fmt, args);
   va_end(args);
+  writeMessage(g_warnFile,g_warningStr+text.str(),jsonMessage(QCString(),0,g_warningStr,text));
   handle_warn_as_error();
 }
 
@@ -204,8 +402,9 @@ void err(const char *fmt, ...)
 {
   va_list args;
   va_start(args, fmt);
-  vfprintf(g_warnFile, (QCString(g_errorStr) + fmt).data(), args);
+  QCString text = vformat(fmt, args);
   va_end(args);
+  writeMessage(g_warnFile,g_errorStr+text.str(),jsonMessage(QCString(),0,g_errorStr,text));
   handle_warn_as_error();
 }
 
@@ -219,23 +418,23 @@ extern void err_full(const QCString &file,int line,const char *fmt, ...)
 
 void term(const char *fmt, ...)
 {
+  va_list args;
+  va_start(args, fmt);
+  QCString text = vformat(fmt, args);
+  va_end(args);
+  std::string msgText = g_errorStr+text.str();
+  if (g_warnFile != stderr)
   {
-    std::unique_lock<std::mutex> lock(g_mutex);
-    va_list args;
-    va_start(args, fmt);
-    vfprintf(g_warnFile, (QCString(g_errorStr) + fmt).data(), args);
-    va_end(args);
-    if (g_warnFile != stderr)
-    {
-      for (int i = 0; i < (int)strlen(g_errorStr); i++) fprintf(g_warnFile, " ");
-      fprintf(g_warnFile, "%s\n", "Exiting...");
-    }
+    msgText += std::string(strlen(g_errorStr),' ') + "Exiting...\n";
   }
+  writeMessage(g_warnFile,std::move(msgText),jsonMessage(QCString(),0,g_errorStr,text));
+  flushMessages();
   exit(1);
 }
 
 void warn_flush()
 {
+  flushMessages();
   fflush(g_warnFile);
 }
 
@@ -270,6 +469,7 @@ void printlex(int dbg, bool enter, const char *lexName, const char *fileName)
 
 extern void finishWarnExit()
 {
+  flushMessages();
   if (g_warnStat && g_warnBehavior == WARN_AS_ERROR_t::FAIL_ON_WARNINGS)
   {
     exit(1);
@@ -9,10 +9,12 @@
 #undef UNICODE
 #define _WIN32_DCOM
 #include <windows.h>
+#include <psapi.h>
 #else
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
 #include <errno.h>
 extern char **environ;
 #endif
@@ -484,6 +486,53 @@ double Portable::getSysElapsedTime()
   return g_sysElapsedTime;
 }
 
+double Portable::getCpuTime()
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (!GetProcessTimes(GetCurrentProcess(),&creationTime,&exitTime,&kernelTime,&userTime))
+  {
+    return 0.0;
+  }
+  auto toSeconds = [](const FILETIME &ft) // FILETIME counts in units of 100ns
+  {
+    return static_cast<double>((static_cast<uint64_t>(ft.dwHighDateTime)<<32) | ft.dwLowDateTime)/1.0e7;
+  };
+  return toSeconds(kernelTime)+toSeconds(userTime);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF,&usage)!=0)
+  {
+    return 0.0;
+  }
+  return static_cast<double>(usage.ru_utime.tv_sec+usage.ru_stime.tv_sec)+
+         static_cast<double>(usage.ru_utime.tv_usec+usage.ru_stime.tv_usec)/1.0e6;
+#endif
+}
+
+uint64_t Portable::getPeakMemoryUsage()
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(),&counters,sizeof(counters)))
+  {
+    return 0;
+  }
+  return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF,&usage)!=0)
+  {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return static_cast<uint64_t>(usage.ru_maxrss);      // in bytes
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss)*1024; // in kilobytes
+#endif
+#endif
+}
+
 void Portable::sleep(int ms)
 {
 #if defined(_WIN32) && !defined(__CYGWIN__)
@@ -41,6 +41,8 @@ namespace Portable
   void           sysTimerStart();
   void           sysTimerStop();
   double         getSysElapsedTime();
+  double         getCpuTime();
+  uint64_t       getPeakMemoryUsage();
   void           sleep(int ms);
   bool           isAbsolutePath(const QCString &fileName);
   void           correct_path();
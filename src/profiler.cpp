@@ -0,0 +1,355 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "profiler.h"
+#include "message.h"
+#include "textstream.h"
+#include "settings.h"
+
+//------------------------------------------------------------------------
+// Counting memory allocations
+
+#if COUNT_ALLOCATIONS
+
+// The global operator new and delete are replaced to count the allocations.
+// Since this affects every allocation of the program (and tools such as
+// sanitizers that check new/delete pairs), it is only compiled in when
+// doxygen is configured with the count_allocations option.
+// Aligned allocations (C++17) are not counted.
+
+namespace
+{
+
+const int numAllocCounters = 16;
+
+// one counter per cache line, so threads do not contend on the same counter
+struct alignas(64) AllocCounter
+{
+  std::atomic<uint64_t> count { 0 };
+};
+
+AllocCounter g_allocCounters[numAllocCounters];
+std::atomic<bool> g_countAllocations { false };
+std::atomic<unsigned int> g_nextAllocCounter { 0 };
+
+inline void countAllocation()
+{
+  static thread_local unsigned int counter = g_nextAllocCounter++ % numAllocCounters;
+  g_allocCounters[counter].count.fetch_add(1,std::memory_order_relaxed);
+}
+
+inline void *allocate(std::size_t size)
+{
+  if (g_countAllocations.load(std::memory_order_relaxed))
+  {
+    countAllocation();
+  }
+  void *ptr = std::malloc(size==0 ? 1 : size);
+  if (ptr==0)
+  {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+  return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+  return allocate(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr,std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr,std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+#endif
+
+//------------------------------------------------------------------------
+
+namespace
+{
+
+// maximum number of scopes per thread that are written to the trace, the
+// summary always covers all scopes.
+const size_t maxTraceEvents = 100000;
+
+struct Event
+{
+  const char *name;
+  std::string detail;
+  uint64_t    start;     // in microseconds since the start of profiling
+  uint64_t    duration;  // in microseconds
+};
+
+struct OpenScope
+{
+  const char *name;
+  std::string detail;
+  uint64_t    start;     // in microseconds since the start of profiling
+  uint64_t    childTime; // time spent in nested scopes, in microseconds
+};
+
+struct Total
+{
+  size_t   count = 0;
+  uint64_t time = 0;     // inclusive time, in microseconds
+  uint64_t selfTime = 0; // exclusive time, in microseconds
+};
+
+struct ThreadData
+{
+  explicit ThreadData(unsigned int id) : tid(id) {}
+  unsigned int tid;
+  std::vector<Event>     events;  // the scopes written to the trace
+  std::vector<OpenScope> open;    // the scopes that have not ended yet
+  std::unordered_map<const char *,Total> totals; // per scope name
+  size_t numDropped = 0;          // number of scopes not written to the trace
+};
+
+thread_local ThreadData *t_threadData = 0;
+
+// strips the trailing newline and dots of the messages passed to the statistics
+std::string scopeName(const char *name)
+{
+  std::string s = name;
+  size_t e = s.find_last_not_of(". \t\n");
+  return e==std::string::npos ? s : s.substr(0,e+1);
+}
+
+void writeJsonString(TextStream &t,const std::string &s)
+{
+  static const char hex[] = "0123456789abcdef";
+  t << "\"";
+  for (unsigned char c : s)
+  {
+    switch (c)
+    {
+      case '"':  t << "\\\""; break;
+      case '\\': t << "\\\\"; break;
+      case '\n': t << "\\n";  break;
+      case '\t': t << "\\t";  break;
+      default:
+        if (c<0x20)
+        {
+          t << "\\u00" << hex[c>>4] << hex[c&0xF];
+        }
+        else
+        {
+          t << static_cast<char>(c);
+        }
+        break;
+    }
+  }
+  t << "\"";
+}
+
+} // namespace
+
+struct Profiler::Private
+{
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  mutable std::mutex mutex;
+  std::vector< std::unique_ptr<ThreadData> > threads;
+
+  uint64_t now() const
+  {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now()-startTime).count());
+  }
+  ThreadData *threadData()
+  {
+    if (t_threadData==0)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      threads.push_back(std::make_unique<ThreadData>(static_cast<unsigned int>(threads.size()+1)));
+      t_threadData = threads.back().get();
+    }
+    return t_threadData;
+  }
+};
+
+Profiler::Profiler() : p(std::make_unique<Private>())
+{
+#if COUNT_ALLOCATIONS
+  g_countAllocations = isEnabled();
+#endif
+}
+
+Profiler::~Profiler()
+{
+#if COUNT_ALLOCATIONS
+  g_countAllocations = false;
+#endif
+}
+
+Profiler &Profiler::instance()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+void Profiler::begin(const char *name,const QCString &detail)
+{
+  ThreadData *td = p->threadData();
+  td->open.push_back(OpenScope{ name, detail.str(), p->now(), 0 });
+}
+
+void Profiler::end()
+{
+  ThreadData *td = p->threadData();
+  if (td->open.empty()) return;
+  OpenScope &scope = td->open.back();
+  uint64_t duration = p->now()-scope.start;
+  Total &total = td->totals[scope.name];
+  total.count++;
+  total.time     += duration;
+  total.selfTime += duration-std::min(duration,scope.childTime);
+  if (td->events.size()<maxTraceEvents)
+  {
+    td->events.push_back(Event{ scope.name, std::move(scope.detail), scope.start, duration });
+  }
+  else
+  {
+    td->numDropped++;
+  }
+  td->open.pop_back();
+  if (!td->open.empty())
+  {
+    td->open.back().childTime += duration;
+  }
+}
+
+bool Profiler::countsAllocations()
+{
+  return COUNT_ALLOCATIONS;
+}
+
+uint64_t Profiler::numAllocations() const
+{
+  uint64_t total = 0;
+#if COUNT_ALLOCATIONS
+  for (const auto &counter : g_allocCounters)
+  {
+    total += counter.count.load(std::memory_order_relaxed);
+  }
+#endif
+  return total;
+}
+
+void Profiler::writeTrace(const QCString &fileName) const
+{
+  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  if (!f.is_open())
+  {
+    err("Cannot open file %s for writing!\n",qPrint(fileName));
+    return;
+  }
+  TextStream t(&f);
+  std::lock_guard<std::mutex> lock(p->mutex);
+  t << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+  for (const auto &td : p->threads)
+  {
+    if (!first) t << ",\n";
+    first = false;
+    t << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << td->tid
+      << ",\"args\":{\"name\":\"" << (td->tid==1 ? "main" : "worker") << " " << td->tid << "\"}}";
+    for (const auto &e : td->events)
+    {
+      t << ",\n{\"name\":";
+      writeJsonString(t,scopeName(e.name));
+      t << ",\"cat\":\"doxygen\",\"ph\":\"X\",\"pid\":1,\"tid\":" << td->tid
+        << ",\"ts\":" << std::to_string(e.start) << ",\"dur\":" << std::to_string(e.duration);
+      if (!e.detail.empty())
+      {
+        t << ",\"args\":{\"detail\":";
+        writeJsonString(t,e.detail);
+        t << "}";
+      }
+      t << "}";
+    }
+  }
+  t << "\n]}\n";
+}
+
+void Profiler::printSummary() const
+{
+  std::map<std::string,Total> totals;
+  size_t numDropped = 0;
+  {
+    std::lock_guard<std::mutex> lock(p->mutex);
+    for (const auto &td : p->threads)
+    {
+      for (const auto &kv : td->totals)
+      {
+        Total &total = totals[scopeName(kv.first)];
+        total.count    += kv.second.count;
+        total.time     += kv.second.time;
+        total.selfTime += kv.second.selfTime;
+      }
+      numDropped += td->numDropped;
+    }
+  }
+  std::vector< std::pair<std::string,Total> > sorted(totals.begin(),totals.end());
+  std::sort(sorted.begin(),sorted.end(),
+      [](const auto &t1,const auto &t2) { return t1.second.selfTime>t2.second.selfTime; });
+  msg("Profile (sorted on exclusive time, summed over all threads):\n");
+  for (const auto &kv : sorted)
+  {
+    msg("  %10.3f s exclusive %10.3f s inclusive %9zu calls  %s\n",
+        static_cast<double>(kv.second.selfTime)/1.0e6,
+        static_cast<double>(kv.second.time)/1.0e6,
+        kv.second.count,kv.first.c_str());
+  }
+  if (numDropped>0)
+  {
+    msg("  %zu scopes were not written to the trace, only the first %zu per thread are kept\n",
+        numDropped,maxTraceEvents);
+  }
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <memory>
+
+#include "debug.h"
+#include "qcstring.h"
+
+/** @brief Records the time spent in nested scopes on all threads.
+ *
+ *  Profiling is enabled with the \c -d \c perf command line option.
+ *  Scopes are marked with ProfileScope objects. At the end of the run the
+ *  recorded scopes are written as a trace in the Chrome trace event format
+ *  (viewable in chrome://tracing, Perfetto or speedscope) and a summary per
+ *  scope name is printed.
+ */
+class Profiler
+{
+  public:
+    static Profiler &instance();
+
+    /** Returns TRUE if profiling was requested on the command line. */
+    static bool isEnabled() { return Debug::isFlagSet(Debug::Perf); }
+
+    /** Starts a scope named \a name on the current thread.
+     *  \a name must have static storage duration, \a detail is shown as
+     *  an argument of the scope.
+     */
+    void begin(const char *name,const QCString &detail=QCString());
+
+    /** Ends the innermost scope of the current thread. */
+    void end();
+
+    /** Returns TRUE if doxygen was built with allocation counting (the count_allocations
+     *  CMake option), otherwise numAllocations() always returns 0.
+     */
+    static bool countsAllocations();
+
+    /** Returns the number of memory allocations done since profiling started. */
+    uint64_t numAllocations() const;
+
+    /** Writes all recorded scopes to \a fileName in the Chrome trace event format. */
+    void writeTrace(const QCString &fileName) const;
+
+    /** Prints the number of calls and the total time per scope name. */
+    void printSummary() const;
+
+  private:
+    Profiler();
+   ~Profiler();
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+/** @brief Marks the lifetime of the object as a scope of the Profiler.
+ *
+ *  Does nothing if profiling is disabled.
+ */
+class ProfileScope
+{
+  public:
+    ProfileScope(const char *name,const QCString &detail=QCString())
+      : m_active(Profiler::isEnabled())
+    {
+      if (m_active) Profiler::instance().begin(name,detail);
+    }
+   ~ProfileScope()
+    {
+      if (m_active) Profiler::instance().end();
+    }
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+  private:
+    bool m_active;
+};
+
+#endif
@@ -0,0 +1,109 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "scheduler.h"
+#include "threadpool.h"
+#include "config.h"
+
+struct Scheduler::Private
+{
+  std::mutex poolMutex;
+  std::unique_ptr<ThreadPool> pool;
+  std::atomic<uint64_t> dotBusyTime { 0 }; // in microseconds
+};
+
+Scheduler::Scheduler() : p(std::make_unique<Private>())
+{
+}
+
+Scheduler::~Scheduler()
+{
+  shutdown();
+}
+
+Scheduler &Scheduler::instance()
+{
+  static Scheduler s;
+  return s;
+}
+
+static std::size_t numProcessors()
+{
+  return std::max(1u,std::thread::hardware_concurrency());
+}
+
+std::size_t Scheduler::numThreads() const
+{
+  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+  if (numThreads==0)
+  {
+    numThreads = numProcessors();
+  }
+  return numThreads;
+}
+
+std::size_t Scheduler::numDotThreads() const
+{
+  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(DOT_NUM_THREADS));
+  if (numThreads==0) // automatic
+  {
+    if (Config_getInt(NUM_PROC_THREADS)==1) // no processing budget configured
+    {
+      numThreads = std::max<std::size_t>(2,numProcessors()+1);
+    }
+    else // stay within the processing budget
+    {
+      numThreads = this->numThreads();
+    }
+  }
+  return numThreads;
+}
+
+ThreadPool &Scheduler::threadPool()
+{
+  std::lock_guard<std::mutex> lock(p->poolMutex);
+  if (!p->pool)
+  {
+    p->pool = std::make_unique<ThreadPool>(numThreads());
+  }
+  return *p->pool;
+}
+
+void Scheduler::addDotBusyTime(double seconds)
+{
+  p->dotBusyTime += static_cast<uint64_t>(seconds*1000000.0);
+}
+
+Scheduler::Usage Scheduler::usage() const
+{
+  Usage result;
+  {
+    std::lock_guard<std::mutex> lock(p->poolMutex);
+    if (p->pool) result.poolBusyTime = p->pool->busyTime();
+  }
+  result.dotBusyTime = static_cast<double>(p->dotBusyTime.load())/1000000.0;
+  return result;
+}
+
+void Scheduler::shutdown()
+{
+  std::lock_guard<std::mutex> lock(p->poolMutex);
+  p->pool.reset();
+}
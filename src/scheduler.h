@@ -0,0 +1,73 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstddef>
+#include <memory>
+
+class ThreadPool;
+
+/** @brief Central place that decides how many threads doxygen may use.
+ *
+ *  All parallel phases (parsing, source code generation, documentation
+ *  generation, and running dot) size themselves via this class, so the
+ *  budget configured with \c NUM_PROC_THREADS is respected. The phases that
+ *  run on the generic thread pool share a single pool instead of each
+ *  starting their own threads.
+ */
+class Scheduler
+{
+  public:
+    /** Accumulated time that worker threads spent executing tasks. */
+    struct Usage
+    {
+      double poolBusyTime = 0.0; //!< seconds spent in tasks of the shared thread pool
+      double dotBusyTime  = 0.0; //!< seconds spent running dot jobs
+    };
+
+    static Scheduler &instance();
+
+    /** Returns the number of threads the processing phases may use (at least 1). */
+    std::size_t numThreads() const;
+
+    /** Returns the number of dot jobs that may run in parallel. */
+    std::size_t numDotThreads() const;
+
+    /** Returns the thread pool that is shared by all processing phases.
+     *  The pool is started on first use and has numThreads() workers.
+     */
+    ThreadPool &threadPool();
+
+    /** Called by the dot worker threads to report the time spent on a job. */
+    void addDotBusyTime(double seconds);
+
+    /** Returns the busy time accumulated so far. */
+    Usage usage() const;
+
+    /** Stops the worker threads of the shared pool. */
+    void shutdown();
+
+  private:
+    Scheduler();
+   ~Scheduler();
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
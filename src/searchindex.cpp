@@ -16,7 +16,12 @@
 
 #include <ctype.h>
 #include <assert.h>
+#include <string.h>
 #include <sstream>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <unordered_map>
 
 #include "searchindex.h"
 #include "config.h"
@@ -52,6 +57,10 @@
 //               + for each url containing the word 8 bytes statistics
 //                 (4 bytes index to url string + 4 bytes frequency counter)
 //   for each url: a \0 terminated string
+//
+// Next to this file a binary index (search.dxi) is written that search tools
+// can map into memory and query without scanning, see writeBinary() below
+// and the reader in addon/doxyindexquery.
 
 const size_t numIndexEntries = 256*256;
 
@@ -258,6 +267,164 @@ static void writeString(std::ostream &f,const QCString &s)
   f.put(0);
 }
 
+//---------------------------------------------------------------------------
+// binary search index
+//
+// file format, version 1: (all fixed size values are little endian,
+// all sections start at an 8 byte boundary)
+//   header (72 bytes):
+//     "DXSI", version (u32), number of terms (u32), number of docs (u32),
+//     terms per block (u32), number of blocks (u32),
+//     offsets (u64) of the block index, term blocks, postings, doc index
+//     and docs sections, and the total file size (u64)
+//   block index: for each block the offset (u32) of the block relative to
+//     the start of the term blocks section
+//   term blocks: the terms in byte order, in blocks of 'terms per block'.
+//     Per term: the length of the prefix shared with the previous term of
+//     the block (varint, always 0 for the first term of a block), the
+//     length of the rest of the term (varint), the rest of the term, the
+//     offset of its postings relative to the postings section (varint) and
+//     the number of postings (varint)
+//   postings: per term and per doc containing the term, in doc order: the
+//     difference with the previous doc id (varint) and the frequency (varint,
+//     the number of occurrences times 2, plus 1 for a high priority doc)
+//   doc index: for each doc the offset (u32) relative to the docs section
+//   docs: per doc the length of the name (varint), the name, the
+//     length of the url (varint) and the url
+// varints are stored in 7 bit groups, least significant group first, with
+// the high bit set on all but the last byte.
+
+static const uint32_t binaryIndexVersion = 1;
+static const uint32_t termsPerBlock      = 16;
+
+static void putVarint(std::string &buf,uint64_t value)
+{
+  while (value>=0x80)
+  {
+    buf+=static_cast<char>((value&0x7f)|0x80);
+    value>>=7;
+  }
+  buf+=static_cast<char>(value);
+}
+
+static void putU32(std::string &buf,uint32_t value)
+{
+  for (int i=0;i<4;i++) buf+=static_cast<char>((value>>(8*i))&0xff);
+}
+
+static void putU64(std::string &buf,uint64_t value)
+{
+  for (int i=0;i<8;i++) buf+=static_cast<char>((value>>(8*i))&0xff);
+}
+
+static void alignTo8(std::string &buf)
+{
+  while (buf.size()%8!=0) buf+='\0';
+}
+
+void SearchIndex::writeBinary(const QCString &fileName)
+{
+  // sort the words in byte order
+  std::vector<const IndexWord *> words;
+  words.reserve(m_words.size());
+  for (const auto &wlist : m_index)
+  {
+    for (const auto &iw : wlist)
+    {
+      words.push_back(&iw);
+    }
+  }
+  std::sort(words.begin(),words.end(),[](const IndexWord *w1,const IndexWord *w2)
+      { return strcmp(w1->word().data(),w2->word().data())<0; }); // strcmp compares unsigned bytes
+
+  // assign consecutive doc ids in url order
+  std::unordered_map<int,uint32_t> docIds;
+  for (const auto &udi : m_urls)
+  {
+    docIds.insert(std::make_pair(udi.first,static_cast<uint32_t>(docIds.size())));
+  }
+
+  std::string blockIndex, terms, postings;
+  std::string prevWord;
+  for (size_t i=0;i<words.size();i++)
+  {
+    std::string word = words[i]->word().str();
+    size_t shared = 0;
+    if (i%termsPerBlock==0) // start of a new block
+    {
+      putU32(blockIndex,static_cast<uint32_t>(terms.size()));
+    }
+    else
+    {
+      while (shared<word.size() && shared<prevWord.size() && word[shared]==prevWord[shared]) shared++;
+    }
+    std::vector< std::pair<uint32_t,int> > docs; // doc id, frequency
+    for (const auto &kv : words[i]->urls())
+    {
+      auto it = docIds.find(kv.second.urlIdx);
+      if (it!=docIds.end()) docs.push_back(std::make_pair(it->second,kv.second.freq));
+    }
+    std::sort(docs.begin(),docs.end());
+    putVarint(terms,shared);
+    putVarint(terms,word.size()-shared);
+    terms.append(word,shared,std::string::npos);
+    putVarint(terms,postings.size());
+    putVarint(terms,docs.size());
+    uint32_t prevDoc = 0;
+    for (const auto &doc : docs)
+    {
+      putVarint(postings,doc.first-prevDoc);
+      putVarint(postings,static_cast<uint64_t>(doc.second));
+      prevDoc = doc.first;
+    }
+    prevWord = word;
+  }
+
+  std::string docIndex, docs;
+  for (const auto &udi : m_urls)
+  {
+    putU32(docIndex,static_cast<uint32_t>(docs.size()));
+    putVarint(docs,udi.second.name.length());
+    docs.append(udi.second.name.str());
+    putVarint(docs,udi.second.url.length());
+    docs.append(udi.second.url.str());
+  }
+
+  // compute the layout of the sections
+  const uint64_t headerSize = 72;
+  std::vector<std::string*> sections = { &blockIndex, &terms, &postings, &docIndex, &docs };
+  std::vector<uint64_t> offsets;
+  uint64_t offset = headerSize;
+  for (std::string *section : sections)
+  {
+    alignTo8(*section);
+    offsets.push_back(offset);
+    offset+=section->size();
+  }
+
+  std::string header;
+  header.append("DXSI");
+  putU32(header,binaryIndexVersion);
+  putU32(header,static_cast<uint32_t>(words.size()));
+  putU32(header,static_cast<uint32_t>(m_urls.size()));
+  putU32(header,termsPerBlock);
+  putU32(header,static_cast<uint32_t>((words.size()+termsPerBlock-1)/termsPerBlock));
+  for (uint64_t o : offsets) putU64(header,o);
+  putU64(header,offset);
+
+  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  if (!f.is_open())
+  {
+    err("Cannot open file %s for writing!\n",qPrint(fileName));
+    return;
+  }
+  f.write(header.data(),static_cast<std::streamsize>(header.size()));
+  for (const std::string *section : sections)
+  {
+    f.write(section->data(),static_cast<std::streamsize>(section->size()));
+  }
+}
+
 void SearchIndex::write(const QCString &fileName)
 {
   size_t i;
@@ -384,6 +551,8 @@ void SearchIndex::write(const QCString &fileName)
     }
   }
 
+  // the same index in the binary format, for search tools
+  writeBinary(stripExtensionGeneral(fileName,".idx")+".dxi");
 }
 
 
@@ -902,11 +1071,344 @@ void createJavaScriptSearchIndex()
   }
 }
 
-void writeJavaScriptSearchIndex()
+//---------------------------------------------------------------------------------------------
+
+/** Returns the page containing \a d relative to the search directory. */
+static QCString searchResultPage(const Definition *d)
 {
-  // write index files
-  QCString searchDirName = Config_getString(HTML_OUTPUT)+"/search";
+  return externalRef("../",d->getReference(),TRUE) +
+         addHtmlExtensionIfMissing(d->getOutputFileBase());
+}
+
+/** Returns the link to \a d relative to the search directory. */
+static QCString searchResultUrl(const Definition *d)
+{
+  QCString url = searchResultPage(d);
+  QCString anchor = d->anchor();
+  if (!anchor.isEmpty())
+  {
+    url+="#"+anchor;
+  }
+  return url;
+}
+
+/** Returns TRUE if the link to \a d should be opened in the parent window. */
+static bool searchResultInParent(const Definition *d)
+{
+  static bool extLinksInWindow = Config_getBool(EXT_LINKS_IN_WINDOW);
+  return !extLinksInWindow || d->getReference().isEmpty();
+}
+
+/** Returns the scope shown for \a d if it is the only result with its name. */
+static QCString searchResultScope(const Definition *d)
+{
+  if (d->getOuterScope()!=Doxygen::globalScope)
+  {
+    return convertToXML(d->getOuterScope()->name());
+  }
+  const MemberDef *md = toMemberDef(d);
+  if (md)
+  {
+    const FileDef *fd = md->getBodyDef();
+    if (fd==0) fd = md->getFileDef();
+    if (fd)
+    {
+      return convertToXML(fd->localName());
+    }
+  }
+  return QCString();
+}
+
+/** Returns the name shown for \a d if there are multiple results with the same name.
+ *  \a prevScope and \a nextScope are the scopes of the results before and after \a d,
+ *  and are used to detect overloaded functions.
+ */
+static QCString searchResultQualifiedName(const Definition *d,
+                                          const Definition *prevScope,const Definition *nextScope)
+{
+  const Definition *scope = d->getOuterScope();
+  const MemberDef  *md    = toMemberDef(d);
+  bool overloadedFunction = ((prevScope!=0 && scope==prevScope) ||
+      (scope && scope==nextScope)) && md && (md->isFunction() || md->isSlot());
+  QCString prefix;
+  if (md) prefix=convertToXML(md->localName());
+  if (overloadedFunction) // overloaded member function
+  {
+    prefix+=convertToXML(md->argsString());
+    // show argument list to disambiguate overloaded functions
+  }
+  else if (md) // unique member function
+  {
+    prefix+="()"; // only to show it is a function
+  }
+  if (d->definitionType()==Definition::TypeClass)
+  {
+    return convertToXML((toClassDef(d))->displayName());
+  }
+  else if (d->definitionType()==Definition::TypeNamespace)
+  {
+    return convertToXML((toNamespaceDef(d))->displayName());
+  }
+  else if (scope==0 || scope==Doxygen::globalScope) // in global scope
+  {
+    if (md)
+    {
+      const FileDef *fd = md->getBodyDef();
+      if (fd==0) fd = md->resolveAlias()->getFileDef();
+      if (fd)
+      {
+        if (!prefix.isEmpty()) prefix+=":&#160;";
+        return prefix + convertToXML(fd->localName());
+      }
+    }
+  }
+  else if (md && (md->resolveAlias()->getClassDef() || md->resolveAlias()->getNamespaceDef()))
+    // member in class or namespace scope
+  {
+    SrcLangExt lang = md->getLanguage();
+    return convertToXML(d->getOuterScope()->qualifiedName())
+      + getLanguageSpecificSeparator(lang) + prefix;
+  }
+  else if (scope) // some thing else? -> show scope
+  {
+    return prefix + convertToXML(scope->name());
+  }
+  // fallback
+  return prefix + "("+theTranslator->trGlobalNamespace()+")";
+}
+
+//---------------------------------------------------------------------------------------------
+// compact search data (COMPACT_SEARCH_DATA)
+//
+// Each symbol of the "all" index is written once, to the shard for the first letter of its
+// name. Letters with more than maxSearchShardSize symbols are split further on the second
+// letter. A shard file shard_<n>.js contains a single call:
+//
+//   searchShard(n,{
+//     u:[page,...],      // the pages linked to, each page is written once
+//     s:[label,...],     // the scope labels, each label is written once
+//     e:[[id,name,child,...],...] // the symbols grouped by name
+//   });
+//
+// where child = [categories,page index,anchor,unique label index,label index,in parent]
+// and categories has bit j set when the symbol is part of the j-th non-empty index.
+// The unique label is shown when it is the only symbol with this name in a category.
+
+static const size_t maxSearchShardSize = 2000;
+
+/** Returns \a s as a double quoted javascript string. */
+static QCString jsString(const QCString &s)
+{
+  QCString result = "\"";
+  for (uint i=0;i<s.length();i++)
+  {
+    char c = s.at(i);
+    if (c=='"' || c=='\\') result+='\\';
+    result+=c;
+  }
+  result+="\"";
+  return result;
+}
+
+/** Collects the strings of a shard and assigns an index to each unique string. */
+class SearchStringTable
+{
+  public:
+    size_t add(const QCString &s)
+    {
+      auto it = m_indices.find(s.str());
+      if (it!=m_indices.end()) return it->second;
+      size_t index = m_strings.size();
+      m_indices.insert(std::make_pair(s.str(),index));
+      m_strings.push_back(s);
+      return index;
+    }
+    void write(std::ostream &t) const
+    {
+      t << "[";
+      for (size_t i=0;i<m_strings.size();i++)
+      {
+        if (i>0) t << ",";
+        if (i%8==7) t << "\n";
+        t << jsString(m_strings[i]);
+      }
+      t << "]";
+    }
+  private:
+    std::unordered_map<std::string,size_t> m_indices;
+    std::vector<QCString> m_strings;
+};
+
+struct SearchShardItem
+{
+  const Definition *def;
+  QCString name;
+  QCString uniqueLabel;
+  QCString label;
+};
+
+static void writeSearchShard(const QCString &fileName,size_t shard,
+                             const std::vector<SearchShardItem> &items,
+                             const std::unordered_map<const Definition *,uint> &categories)
+{
+  std::ofstream t(fileName.str(), std::ofstream::out | std::ofstream::binary);
+  if (!t.is_open())
+  {
+    err("Failed to open file '%s' for writing...\n",qPrint(fileName));
+    return;
+  }
+  SearchStringTable pages, labels;
+  TextStream entries;
+  QCString lastName;
+  bool first = true;
+  for (const auto &item : items)
+  {
+    if (first || item.name!=lastName)
+    {
+      if (!first) entries << "],\n";
+      entries << "[" << jsString(searchId(item.def)) << "," << jsString(convertToXML(item.name));
+      lastName = item.name;
+      first = false;
+    }
+    auto it = categories.find(item.def);
+    entries << ",[" << (it!=categories.end() ? it->second : 1)
+            << "," << static_cast<uint>(pages.add(searchResultPage(item.def)))
+            << "," << jsString(item.def->anchor())
+            << "," << static_cast<uint>(labels.add(item.uniqueLabel))
+            << "," << static_cast<uint>(labels.add(item.label))
+            << "," << (searchResultInParent(item.def) ? 1 : 0) << "]";
+  }
+  if (!first) entries << "]\n";
+
+  t << "searchShard(" << shard << ",{\n";
+  t << "u:"; pages.write(t); t << ",\n";
+  t << "s:"; labels.write(t); t << ",\n";
+  t << "e:[\n" << entries.str() << "]});\n";
+}
+
+/** Writes the search data shards and the single results page, and returns the key
+ *  (first letter or first two letters) of each shard in \a shardKeys.
+ */
+static void writeCompactSearchData(const QCString &searchDirName,std::vector<std::string> &shardKeys)
+{
+  // determine the categories each symbol belongs to, as a bit mask over the non-empty indices
+  std::unordered_map<const Definition *,uint> categories;
+  uint j=0;
+  for (const auto &sii : g_searchIndexInfo)
+  {
+    if (!sii.symbolMap.empty())
+    {
+      for (const auto &kv : sii.symbolMap)
+      {
+        for (const auto &d : kv.second)
+        {
+          categories[d] |= 1u<<j;
+        }
+      }
+      j++;
+    }
+  }
+
+  size_t shard=0;
+  for (const auto &kv : g_searchIndexInfo[SEARCH_INDEX_ALL].symbolMap)
+  {
+    // compute the labels, using the same neighbours as for the "all" index
+    std::vector<SearchShardItem> items;
+    items.reserve(kv.second.size());
+    const Definition *prevScope = 0;
+    QCString lastName;
+    for (auto it = kv.second.begin(); it!=kv.second.end(); ++it)
+    {
+      const Definition *d = *it;
+      QCString sname = searchName(d);
+      if (sname!=lastName) prevScope=0;
+      const Definition *next = std::next(it)!=kv.second.end() ? *std::next(it) : 0;
+      const Definition *nextScope = next ? next->getOuterScope() : 0;
+      items.push_back(SearchShardItem{ d, sname, searchResultScope(d),
+                                       searchResultQualifiedName(d,prevScope,nextScope) });
+      prevScope = d->getOuterScope();
+      lastName = sname;
+    }
+
+    // split large shards on the second letter
+    std::map< std::string,std::vector<SearchShardItem> > shards;
+    if (items.size()>maxSearchShardSize)
+    {
+      for (auto &item : items)
+      {
+        std::string name = item.name.str();
+        std::string key = kv.first;
+        if (!name.empty())
+        {
+          key+=convertUTF8ToLower(getUTF8CharAt(name,getUTF8CharNumBytes(name[0])));
+        }
+        shards[key].push_back(std::move(item));
+      }
+    }
+    else
+    {
+      shards.insert(std::make_pair(kv.first,std::move(items)));
+    }
+
+    for (const auto &skv : shards)
+    {
+      QCString fileName;
+      fileName.sprintf("%s/shard_%x.js",qPrint(searchDirName),static_cast<uint>(shard));
+      writeSearchShard(fileName,shard,skv.second,categories);
+      shardKeys.push_back(skv.first);
+      shard++;
+    }
+  }
+
+  // the results page, the search box passes "?<index>&<search>"
+  QCString fileName = searchDirName + "/results" + Doxygen::htmlFileExtension;
+  std::ofstream t(fileName.str(), std::ofstream::out | std::ofstream::binary);
+  if (t.is_open())
+  {
+    t << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\""
+      " \"https://www.w3.org/TR/xhtml1/DTD/xhtml1-transitional.dtd\">\n";
+    t << "<html xmlns=\"http://www.w3.org/1999/xhtml\">\n";
+    t << "<head><title></title>\n";
+    t << "<meta http-equiv=\"Content-Type\" content=\"text/xhtml;charset=UTF-8\"/>\n";
+    t << "<meta name=\"generator\" content=\"Doxygen " << getDoxygenVersion() << "\"/>\n";
+    t << "<link rel=\"stylesheet\" type=\"text/css\" href=\"search.css\"/>\n";
+    t << "<script type=\"text/javascript\" src=\"searchdata.js\"></script>\n";
+    t << "<script type=\"text/javascript\" src=\"search.js\"></script>\n";
+    t << "</head>\n";
+    t << "<body class=\"SRPage\">\n";
+    t << "<div id=\"SRIndex\">\n";
+    t << "<div class=\"SRStatus\" id=\"Loading\">" << theTranslator->trLoading() << "</div>\n";
+    t << "<div id=\"SRResults\"></div>\n"; // here the results will be inserted
+    t << "<div class=\"SRStatus\" id=\"Searching\">"
+      << theTranslator->trSearching() << "</div>\n";
+    t << "<div class=\"SRStatus\" id=\"NoMatches\">"
+      << theTranslator->trNoMatches() << "</div>\n";
+    t << "<script type=\"text/javascript\">\n";
+    t << "/* @license magnet:?xt=urn:btih:d3d9a9a6595521f9666a5e94cc830dab83b65699&amp;dn=expat.txt MIT */\n";
+    t << "document.getElementById(\"NoMatches\").style.display=\"none\";\n";
+    t << "var searchResults = new SearchResults(\"searchResults\");\n";
+    t << "searchResults.SearchCompact();\n"; // loads the data, inserts the results and searches
+    t << "window.addEventListener(\"message\", function(event) {\n";
+    t << "  if (event.data == \"take_focus\") {\n";
+    t << "    var elem = searchResults.NavNext(0);\n";
+    t << "    if (elem) elem.focus();\n";
+    t << "  }\n";
+    t << "});\n";
+    t << "/* @license-end */\n";
+    t << "</script>\n";
+    t << "</div>\n"; // SRIndex
+    t << "</body>\n";
+    t << "</html>\n";
+  }
+  else
+  {
+    err("Failed to open file '%s' for writing...\n",qPrint(fileName));
+  }
+}
 
+/** Writes a results page and a data file for each index and first letter. */
+static void writeSearchPages(const QCString &searchDirName)
+{
   for (auto &sii : g_searchIndexInfo)
   {
     int p=0;
@@ -1008,112 +1510,22 @@ void writeJavaScriptSearchIndex()
           const Definition *scope     = d->getOuterScope();
           const Definition *next      = it!=kv.second.end() ? *it : 0;
           const Definition *nextScope = 0;
-          const MemberDef  *md        = toMemberDef(d);
           if (next) nextScope = next->getOuterScope();
-          QCString anchor = d->anchor();
 
           if (childCount>0)
           {
             ti << "],[";
           }
-          ti << "'" << externalRef("../",d->getReference(),TRUE)
-            << addHtmlExtensionIfMissing(d->getOutputFileBase());
-          if (!anchor.isEmpty())
-          {
-            ti << "#" << anchor;
-          }
-          ti << "',";
-
-          static bool extLinksInWindow = Config_getBool(EXT_LINKS_IN_WINDOW);
-          if (!extLinksInWindow || d->getReference().isEmpty())
-          {
-            ti << "1,";
-          }
-          else
-          {
-            ti << "0,";
-          }
+          ti << "'" << searchResultUrl(d) << "',";
+          ti << (searchResultInParent(d) ? "1," : "0,");
 
           if (lastName!=sname && (next==0 || searchName(next)!=sname)) // unique name
           {
-            if (d->getOuterScope()!=Doxygen::globalScope)
-            {
-              ti << "'" << convertToXML(d->getOuterScope()->name()) << "'";
-            }
-            else if (md)
-            {
-              const FileDef *fd = md->getBodyDef();
-              if (fd==0) fd = md->getFileDef();
-              if (fd)
-              {
-                ti << "'" << convertToXML(fd->localName()) << "'";
-              }
-            }
-            else
-            {
-              ti << "''";
-            }
+            ti << "'" << searchResultScope(d) << "'";
           }
           else // multiple entries with the same name
           {
-            bool found=FALSE;
-            bool overloadedFunction = ((prevScope!=0 && scope==prevScope) ||
-                (scope && scope==nextScope)) && md && (md->isFunction() || md->isSlot());
-            QCString prefix;
-            if (md) prefix=convertToXML(md->localName());
-            if (overloadedFunction) // overloaded member function
-            {
-              prefix+=convertToXML(md->argsString());
-              // show argument list to disambiguate overloaded functions
-            }
-            else if (md) // unique member function
-            {
-              prefix+="()"; // only to show it is a function
-            }
-            QCString name;
-            if (d->definitionType()==Definition::TypeClass)
-            {
-              name = convertToXML((toClassDef(d))->displayName());
-              found = TRUE;
-            }
-            else if (d->definitionType()==Definition::TypeNamespace)
-            {
-              name = convertToXML((toNamespaceDef(d))->displayName());
-              found = TRUE;
-            }
-            else if (scope==0 || scope==Doxygen::globalScope) // in global scope
-            {
-              if (md)
-              {
-                const FileDef *fd = md->getBodyDef();
-                if (fd==0) fd = md->resolveAlias()->getFileDef();
-                if (fd)
-                {
-                  if (!prefix.isEmpty()) prefix+=":&#160;";
-                  name = prefix + convertToXML(fd->localName());
-                  found = TRUE;
-                }
-              }
-            }
-            else if (md && (md->resolveAlias()->getClassDef() || md->resolveAlias()->getNamespaceDef()))
-              // member in class or namespace scope
-            {
-              SrcLangExt lang = md->getLanguage();
-              name = convertToXML(d->getOuterScope()->qualifiedName())
-                + getLanguageSpecificSeparator(lang) + prefix;
-              found = TRUE;
-            }
-            else if (scope) // some thing else? -> show scope
-            {
-              name = prefix + convertToXML(scope->name());
-              found = TRUE;
-            }
-            if (!found) // fallback
-            {
-              name = prefix + "("+theTranslator->trGlobalNamespace()+")";
-            }
-
-            ti << "'" << name << "'";
+            ti << "'" << searchResultQualifiedName(d,prevScope,nextScope) << "'";
 
             prevScope = scope;
             childCount++;
@@ -1133,6 +1545,22 @@ void writeJavaScriptSearchIndex()
       p++;
     }
   }
+}
+
+void writeJavaScriptSearchIndex()
+{
+  // write index files
+  QCString searchDirName = Config_getString(HTML_OUTPUT)+"/search";
+
+  std::vector<std::string> shardKeys;
+  if (Config_getBool(COMPACT_SEARCH_DATA))
+  {
+    writeCompactSearchData(searchDirName,shardKeys);
+  }
+  else
+  {
+    writeSearchPages(searchDirName);
+  }
 
   {
     std::ofstream t(searchDirName.str()+"/searchdata.js",
@@ -1188,6 +1616,18 @@ void writeJavaScriptSearchIndex()
       }
       if (j>0) t << "\n";
       t << "};\n\n";
+      if (!shardKeys.empty())
+      {
+        t << "var searchShards =\n";
+        t << "[";
+        for (size_t i=0;i<shardKeys.size();i++)
+        {
+          if (i>0) t << ",";
+          if (i%16==0) t << "\n  ";
+          t << jsString(QCString(shardKeys[i]));
+        }
+        t << "\n];\n\n";
+      }
     }
     ResourceMgr::instance().copyResource("search.js",searchDirName);
   }
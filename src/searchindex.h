@@ -87,6 +87,7 @@ class SearchIndex : public SearchIndexIntf
     void write(const QCString &file) override;
   private:
     void addWord(const QCString &word,bool hiPrio,bool recurse);
+    void writeBinary(const QCString &file);
     std::unordered_map<std::string,int> m_words;
     std::vector< std::vector< IndexWord> > m_index;
     std::unordered_map<std::string,int> m_url2IdMap;
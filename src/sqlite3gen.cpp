@@ -16,6 +16,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <sstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 
 #include "settings.h"
 #include "message.h"
@@ -47,6 +51,8 @@
 #include "section.h"
 #include "fileinfo.h"
 #include "dir.h"
+#include "scheduler.h"
+#include "threadpool.h"
 
 #include <sys/stat.h>
 #include <string.h>
@@ -542,10 +548,6 @@ SqlStmt contains_insert={
   ,NULL
 };
 //////////////////////////////////////////////////////
-SqlStmt path_select = {
-  "SELECT rowid FROM path WHERE name=:name"
-  ,NULL
-};
 SqlStmt path_insert = {
   "INSERT INTO path "
     "( type, local, found, name )"
@@ -554,10 +556,6 @@ SqlStmt path_insert = {
   ,NULL
 };
 //////////////////////////////////////////////////////
-SqlStmt refid_select =  {
-  "SELECT rowid FROM refid WHERE refid=:refid"
-  ,NULL
-};
 SqlStmt refid_insert = {
   "INSERT INTO refid "
     "( refid )"
@@ -905,6 +903,12 @@ static int step(SqlStmt &s,bool getRowId=FALSE, bool select=FALSE)
   return rowid;
 }
 
+/* The database is always created from scratch, so the rowids of the path
+   and refid rows can be remembered in memory. This avoids a select per
+   lookup (the path table does not even have an index on name). */
+static std::unordered_map<std::string,int> g_pathRowids;
+static std::unordered_map<std::string,int> g_refidRowids;
+
 static int insertPath(QCString name, bool local=TRUE, bool found=TRUE, int type=1)
 {
   int rowid=-1;
@@ -912,15 +916,19 @@ static int insertPath(QCString name, bool local=TRUE, bool found=TRUE, int type=
 
   name = stripFromPath(name);
 
-  bindTextParameter(path_select,":name",name.data());
-  rowid=step(path_select,TRUE,TRUE);
-  if (rowid==0)
+  auto it = g_pathRowids.find(name.str());
+  if (it!=g_pathRowids.end())
+  {
+    return it->second;
+  }
+  bindTextParameter(path_insert,":name",name.data());
+  bindIntParameter(path_insert,":type",type);
+  bindIntParameter(path_insert,":local",local?1:0);
+  bindIntParameter(path_insert,":found",found?1:0);
+  rowid=step(path_insert,TRUE);
+  if (rowid!=-1)
   {
-    bindTextParameter(path_insert,":name",name.data());
-    bindIntParameter(path_insert,":type",type);
-    bindIntParameter(path_insert,":local",local?1:0);
-    bindIntParameter(path_insert,":found",found?1:0);
-    rowid=step(path_insert,TRUE);
+    g_pathRowids.insert(std::make_pair(name.str(),rowid));
   }
   return rowid;
 }
@@ -951,13 +959,20 @@ struct Refid insertRefid(const QCString &refid)
   ret.created = FALSE;
   if (refid.isEmpty()) return ret;
 
-  bindTextParameter(refid_select,":refid",refid);
-  ret.rowid=step(refid_select,TRUE,TRUE);
-  if (ret.rowid==0)
+  auto it = g_refidRowids.find(refid.str());
+  if (it!=g_refidRowids.end())
+  {
+    ret.rowid=it->second;
+  }
+  else
   {
     bindTextParameter(refid_insert,":refid",refid);
     ret.rowid=step(refid_insert,TRUE);
     ret.created = TRUE;
+    if (ret.rowid!=-1)
+    {
+      g_refidRowids.insert(std::make_pair(refid.str(),ret.rowid));
+    }
   }
 
   return ret;
@@ -1169,9 +1184,7 @@ static int prepareStatements(sqlite3 *db)
   -1==prepareStatement(db, memberdef_update_decl) ||
   -1==prepareStatement(db, member_insert) ||
   -1==prepareStatement(db, path_insert) ||
-  -1==prepareStatement(db, path_select) ||
   -1==prepareStatement(db, refid_insert) ||
-  -1==prepareStatement(db, refid_select) ||
   -1==prepareStatement(db, incl_insert)||
   -1==prepareStatement(db, incl_select)||
   -1==prepareStatement(db, param_insert) ||
@@ -1418,19 +1431,65 @@ QCString getSQLDocBlock(const Definition *scope,
   return convertCharEntitiesToUTF8(t.str().c_str());
 }
 
+/** Descriptions of a group of compounds and their members, converted to
+ *  XML by the worker threads before the compounds are written to the database.
+ */
+class SqlDescriptionBatch
+{
+  public:
+    void add(const Definition *def,const char *col,const QCString &value)
+    {
+      QCString xml = getSQLDocBlock(def->getOuterScope(),def,value,def->docFile(),def->docLine());
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_descriptions[std::make_pair(def,std::string(col))] = Description{ value, xml };
+    }
+    void addMember(const Definition *scope,const MemberDef *md)
+    {
+      // same filters as generateSqlite3Section() and generateSqlite3ForMember()
+      if (scope->definitionType()==Definition::TypeFile && md->getNamespaceDef()!=0) return;
+      if (md->memberType()==MemberType_EnumValue || md->isHidden()) return;
+      add(md,":briefdescription",md->briefDescription());
+      add(md,":detaileddescription",md->documentation());
+      add(md,":inbodydescription",md->inbodyDocumentation());
+    }
+    bool find(const Definition *def,const char *col,const QCString &value,QCString &xml) const
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_descriptions.find(std::make_pair(def,std::string(col)));
+      if (it!=m_descriptions.end() && it->second.value==value)
+      {
+        xml = it->second.xml;
+        return true;
+      }
+      return false;
+    }
+  private:
+    struct Description
+    {
+      QCString value;
+      QCString xml;
+    };
+    mutable std::mutex m_mutex;
+    std::map< std::pair<const Definition *,std::string>, Description > m_descriptions;
+};
+
+// the batch of the compounds that are currently written (if any)
+static const SqlDescriptionBatch *g_descriptionBatch = 0;
+
 static void getSQLDesc(SqlStmt &s,const char *col,const QCString &value,const Definition *def)
 {
-  bindTextParameter(
-    s,
-    col,
-    getSQLDocBlock(
+  QCString xml;
+  if (g_descriptionBatch==0 || !g_descriptionBatch->find(def,col,value,xml))
+  {
+    xml = getSQLDocBlock(
       def->getOuterScope(),
       def,
       value,
       def->docFile(),
       def->docLine()
-    )
-  );
+    );
+  }
+  bindTextParameter(s,col,xml);
 }
 ////////////////////////////////////////////
 
@@ -2429,6 +2488,161 @@ static void generateSqlite3ForPage(const PageDef *pd,bool isExample)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////
+/* Converting the descriptions to XML is the most expensive part of
+   generating the database. The prepareSqlite3For* functions do this up front
+   on the worker threads, using the same filters as the generateSqlite3For*
+   functions that write the compounds. */
+
+static void prepareSqlite3Section(SqlDescriptionBatch &batch,const Definition *d,const MemberList *ml)
+{
+  for (const auto &md : *ml)
+  {
+    batch.addMember(d,md);
+  }
+}
+
+static void prepareSqlite3ForClass(SqlDescriptionBatch &batch,const ClassDef *cd)
+{
+  if (cd->isReference() || cd->isHidden() || cd->isAnonymous() || cd->templateMaster()!=0) return;
+  batch.add(cd,":briefdescription",cd->briefDescription());
+  batch.add(cd,":detaileddescription",cd->documentation());
+  for (const auto &mg : cd->getMemberGroups())
+  {
+    prepareSqlite3Section(batch,cd,&mg->members());
+  }
+  for (const auto &ml : cd->getMemberLists())
+  {
+    if ((ml->listType()&MemberListType_detailedLists)==0)
+    {
+      prepareSqlite3Section(batch,cd,ml.get());
+    }
+  }
+}
+
+static void prepareSqlite3ForConcept(SqlDescriptionBatch &batch,const ConceptDef *cd)
+{
+  if (cd->isReference() || cd->isHidden()) return;
+  batch.add(cd,":briefdescription",cd->briefDescription());
+  batch.add(cd,":detaileddescription",cd->documentation());
+}
+
+template<class T>
+static void prepareSqlite3ForContainer(SqlDescriptionBatch &batch,const T *d)
+{
+  batch.add(d,":briefdescription",d->briefDescription());
+  batch.add(d,":detaileddescription",d->documentation());
+  for (const auto &mg : d->getMemberGroups())
+  {
+    prepareSqlite3Section(batch,d,&mg->members());
+  }
+  for (const auto &ml : d->getMemberLists())
+  {
+    if ((ml->listType()&MemberListType_declarationLists)!=0)
+    {
+      prepareSqlite3Section(batch,d,ml.get());
+    }
+  }
+}
+
+static void prepareSqlite3ForNamespace(SqlDescriptionBatch &batch,const NamespaceDef *nd)
+{
+  if (nd->isReference() || nd->isHidden()) return;
+  prepareSqlite3ForContainer(batch,nd);
+}
+
+static void prepareSqlite3ForFile(SqlDescriptionBatch &batch,const FileDef *fd)
+{
+  if (fd->isReference()) return;
+  prepareSqlite3ForContainer(batch,fd);
+}
+
+static void prepareSqlite3ForGroup(SqlDescriptionBatch &batch,const GroupDef *gd)
+{
+  if (gd->isReference()) return;
+  prepareSqlite3ForContainer(batch,gd);
+}
+
+static void prepareSqlite3ForDefinition(SqlDescriptionBatch &batch,const Definition *d)
+{
+  if (d->isReference()) return;
+  batch.add(d,":briefdescription",d->briefDescription());
+  batch.add(d,":detaileddescription",d->documentation());
+}
+
+/** A compound of the database: \a prepare converts its descriptions
+ *  (on a worker thread), \a write inserts its rows (on the main thread).
+ */
+struct SqlCompound
+{
+  std::function<void(SqlDescriptionBatch &)> prepare;
+  std::function<void()> write;
+};
+
+/** Writes \a compounds to the database in order. When multiple threads are
+ *  available, the compounds are processed in batches: while the main thread
+ *  writes the rows of one batch, the worker threads prepare the descriptions
+ *  of the next one.
+ */
+static void generateSqlite3Compounds(const std::vector<SqlCompound> &compounds)
+{
+  std::size_t numThreads = Scheduler::instance().numThreads();
+  if (numThreads<=1) // single threaded processing
+  {
+    for (const auto &compound : compounds)
+    {
+      compound.write();
+    }
+    return;
+  }
+
+  struct Batch
+  {
+    std::size_t first = 0;
+    std::size_t last = 0;
+    SqlDescriptionBatch descriptions;
+    std::vector< std::future<void> > results;
+  };
+  ThreadPool &threadPool = Scheduler::instance().threadPool();
+  const std::size_t batchSize = numThreads*8;
+  auto startBatch = [&](std::size_t first)
+  {
+    auto batch = std::make_unique<Batch>();
+    batch->first = first;
+    batch->last  = std::min(first+batchSize,compounds.size());
+    std::vector< std::function<void()> > tasks;
+    for (std::size_t i=batch->first; i<batch->last; i++)
+    {
+      const SqlCompound *compound = &compounds[i];
+      SqlDescriptionBatch *descriptions = &batch->descriptions;
+      tasks.push_back([compound,descriptions]() { compound->prepare(*descriptions); });
+    }
+    batch->results = threadPool.queueBatch(tasks);
+    return batch;
+  };
+
+  std::unique_ptr<Batch> next;
+  for (std::size_t first=0; first<compounds.size(); first+=batchSize)
+  {
+    std::unique_ptr<Batch> current = next ? std::move(next) : startBatch(first);
+    if (current->last<compounds.size())
+    {
+      next = startBatch(current->last);
+    }
+    for (auto &f : current->results)
+    {
+      f.get();
+    }
+    g_descriptionBatch = &current->descriptions;
+    for (std::size_t i=current->first; i<current->last; i++)
+    {
+      compounds[i].write();
+    }
+    g_descriptionBatch = 0;
+  }
+}
+
+
 static sqlite3* openDbConnection()
 {
 
@@ -2508,27 +2722,47 @@ void generateSqlite3()
     return;
   }
 
+  g_pathRowids.clear();
+  g_refidRowids.clear();
+
   recordMetadata();
 
+  std::vector<SqlCompound> compounds;
+
   // + classes
   for (const auto &cd : *Doxygen::classLinkedMap)
   {
-    msg("Generating Sqlite3 output for class %s\n",qPrint(cd->name()));
-    generateSqlite3ForClass(cd.get());
+    compounds.push_back(SqlCompound{
+      [cd=cd.get()](SqlDescriptionBatch &batch) { prepareSqlite3ForClass(batch,cd); },
+      [cd=cd.get()]()
+      {
+        msg("Generating Sqlite3 output for class %s\n",qPrint(cd->name()));
+        generateSqlite3ForClass(cd);
+      }});
   }
 
   // + concepts
   for (const auto &cd : *Doxygen::conceptLinkedMap)
   {
-    msg("Generating Sqlite3 output for concept %s\n",qPrint(cd->name()));
-    generateSqlite3ForConcept(cd.get());
+    compounds.push_back(SqlCompound{
+      [cd=cd.get()](SqlDescriptionBatch &batch) { prepareSqlite3ForConcept(batch,cd); },
+      [cd=cd.get()]()
+      {
+        msg("Generating Sqlite3 output for concept %s\n",qPrint(cd->name()));
+        generateSqlite3ForConcept(cd);
+      }});
   }
 
   // + namespaces
   for (const auto &nd : *Doxygen::namespaceLinkedMap)
   {
-    msg("Generating Sqlite3 output for namespace %s\n",qPrint(nd->name()));
-    generateSqlite3ForNamespace(nd.get());
+    compounds.push_back(SqlCompound{
+      [nd=nd.get()](SqlDescriptionBatch &batch) { prepareSqlite3ForNamespace(batch,nd); },
+      [nd=nd.get()]()
+      {
+        msg("Generating Sqlite3 output for namespace %s\n",qPrint(nd->name()));
+        generateSqlite3ForNamespace(nd);
+      }});
   }
 
   // + files
@@ -2536,46 +2770,78 @@ void generateSqlite3()
   {
     for (const auto &fd : *fn)
     {
-      msg("Generating Sqlite3 output for file %s\n",qPrint(fd->name()));
-      generateSqlite3ForFile(fd.get());
+      compounds.push_back(SqlCompound{
+        [fd=fd.get()](SqlDescriptionBatch &batch) { prepareSqlite3ForFile(batch,fd); },
+        [fd=fd.get()]()
+        {
+          msg("Generating Sqlite3 output for file %s\n",qPrint(fd->name()));
+          generateSqlite3ForFile(fd);
+        }});
     }
   }
 
   // + groups
   for (const auto &gd : *Doxygen::groupLinkedMap)
   {
-    msg("Generating Sqlite3 output for group %s\n",qPrint(gd->name()));
-    generateSqlite3ForGroup(gd.get());
+    compounds.push_back(SqlCompound{
+      [gd=gd.get()](SqlDescriptionBatch &batch) { prepareSqlite3ForGroup(batch,gd); },
+      [gd=gd.get()]()
+      {
+        msg("Generating Sqlite3 output for group %s\n",qPrint(gd->name()));
+        generateSqlite3ForGroup(gd);
+      }});
   }
 
   // + page
   for (const auto &pd : *Doxygen::pageLinkedMap)
   {
-    msg("Generating Sqlite3 output for page %s\n",qPrint(pd->name()));
-    generateSqlite3ForPage(pd.get(),FALSE);
+    compounds.push_back(SqlCompound{
+      [pd=pd.get()](SqlDescriptionBatch &batch) { prepareSqlite3ForDefinition(batch,pd); },
+      [pd=pd.get()]()
+      {
+        msg("Generating Sqlite3 output for page %s\n",qPrint(pd->name()));
+        generateSqlite3ForPage(pd,FALSE);
+      }});
   }
 
   // + dirs
   for (const auto &dd : *Doxygen::dirLinkedMap)
   {
-    msg("Generating Sqlite3 output for dir %s\n",qPrint(dd->name()));
-    generateSqlite3ForDir(dd.get());
+    compounds.push_back(SqlCompound{
+      [dd=dd.get()](SqlDescriptionBatch &batch) { prepareSqlite3ForDefinition(batch,dd); },
+      [dd=dd.get()]()
+      {
+        msg("Generating Sqlite3 output for dir %s\n",qPrint(dd->name()));
+        generateSqlite3ForDir(dd);
+      }});
   }
 
   // + examples
   for (const auto &pd : *Doxygen::exampleLinkedMap)
   {
-    msg("Generating Sqlite3 output for example %s\n",qPrint(pd->name()));
-    generateSqlite3ForPage(pd.get(),TRUE);
+    compounds.push_back(SqlCompound{
+      [pd=pd.get()](SqlDescriptionBatch &batch) { prepareSqlite3ForDefinition(batch,pd); },
+      [pd=pd.get()]()
+      {
+        msg("Generating Sqlite3 output for example %s\n",qPrint(pd->name()));
+        generateSqlite3ForPage(pd,TRUE);
+      }});
   }
 
   // + main page
   if (Doxygen::mainPage)
   {
-    msg("Generating Sqlite3 output for the main page\n");
-    generateSqlite3ForPage(Doxygen::mainPage.get(),FALSE);
+    compounds.push_back(SqlCompound{
+      [](SqlDescriptionBatch &batch) { prepareSqlite3ForDefinition(batch,Doxygen::mainPage.get()); },
+      []()
+      {
+        msg("Generating Sqlite3 output for the main page\n");
+        generateSqlite3ForPage(Doxygen::mainPage.get(),FALSE);
+      }});
   }
 
+  generateSqlite3Compounds(compounds);
+
   // TODO: copied from initializeSchema; not certain if we should say/do more
   // if there's a failure here?
   if (-1==initializeViews(db))
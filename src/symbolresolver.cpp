@@ -24,7 +24,6 @@
 #include "config.h"
 #include "defargs.h"
 
-static std::mutex g_cacheMutex;
 static std::recursive_mutex g_cacheTypedefMutex;
 
 //--------------------------------------------------------------------------------------
@@ -258,29 +257,27 @@ const ClassDef *SymbolResolver::Private::getResolvedClassRec(
   }
   *pk='\0';
 
-  LookupInfo *pval = 0;
+  const std::string cacheKey = key.str();
   {
-    std::lock_guard<std::mutex> lock(g_cacheMutex);
-    pval=Doxygen::lookupCache->find(key.str());
-    //printf("Searching for %s result=%p\n",qPrint(key),pval);
-    if (pval)
+    LookupInfo li;
+    if (Doxygen::lookupCache->find(cacheKey,li))
     {
       //printf("LookupInfo %p %p '%s' %p\n",
-      //    pval->classDef, pval->typeDef, qPrint(pval->templSpec),
-      //    qPrint(pval->resolvedType));
-      if (pTemplSpec)    *pTemplSpec=pval->templSpec;
-      if (pTypeDef)      *pTypeDef=pval->typeDef;
-      if (pResolvedType) *pResolvedType=pval->resolvedType;
+      //    li.classDef, li.typeDef, qPrint(li.templSpec),
+      //    qPrint(li.resolvedType));
+      if (pTemplSpec)    *pTemplSpec=li.templSpec;
+      if (pTypeDef)      *pTypeDef=li.typeDef;
+      if (pResolvedType) *pResolvedType=li.resolvedType;
       //fprintf(stderr,"%d ] cachedMatch=%s\n",--level,
-      //    pval->classDef?qPrint(pval->classDef->name()):"<none>");
+      //    li.classDef?qPrint(li.classDef->name()):"<none>");
       //if (pTemplSpec)
       //  printf("templSpec=%s\n",pTemplSpec->data());
-      return pval->classDef;
+      return li.classDef;
     }
     else // not found yet; we already add a 0 to avoid the possibility of
       // endless recursion.
     {
-      pval = Doxygen::lookupCache->insert(key.str(),LookupInfo());
+      Doxygen::lookupCache->insert(cacheKey,LookupInfo());
     }
   }
 
@@ -313,14 +310,8 @@ const ClassDef *SymbolResolver::Private::getResolvedClassRec(
   //printf("getResolvedClassRec: bestMatch=%p pval->resolvedType=%s\n",
   //    bestMatch,qPrint(bestResolvedType));
 
-  if (pval)
-  {
-    std::lock_guard<std::mutex> lock(g_cacheMutex);
-    pval->classDef     = bestMatch;
-    pval->typeDef      = bestTypedef;
-    pval->templSpec    = bestTemplSpec;
-    pval->resolvedType = bestResolvedType;
-  }
+  Doxygen::lookupCache->insert(cacheKey,
+      LookupInfo(bestMatch,bestTypedef,bestTemplSpec,bestResolvedType));
   //fprintf(stderr,"%d ] bestMatch=%s distance=%d\n",--level,
   //    bestMatch?qPrint(bestMatch->name()):"<none>",minDistance);
   //if (pTemplSpec)
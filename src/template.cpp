@@ -19,6 +19,9 @@
 #include <algorithm>
 #include <unordered_map>
 #include <deque>
+#include <mutex>
+#include <thread>
+#include <future>
 #include <cstdio>
 #include <fstream>
 #include <sstream>
@@ -31,6 +34,9 @@
 #include "fileinfo.h"
 #include "dir.h"
 #include "utf8.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "threadpool.h"
 
 #define ENABLE_TRACING 0
 
@@ -253,6 +259,36 @@ const char *TemplateVariant::typeAsString() const
   return "invalid";
 }
 
+//- Template key implementation -----------------------------------------------
+
+namespace
+{
+
+/** @brief Table assigning an id to each field name used as a TemplateKey. */
+class TemplateKeyTable
+{
+  public:
+    static TemplateKeyTable &instance()
+    {
+      static TemplateKeyTable table;
+      return table;
+    }
+    size_t intern(const QCString &name)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_ids.insert(std::make_pair(name.str(),m_ids.size())).first->second;
+    }
+  private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string,size_t> m_ids;
+};
+
+} // namespace
+
+TemplateKey::TemplateKey(const QCString &name) : m_name(name), m_id(TemplateKeyTable::instance().intern(name))
+{
+}
+
 //- Template struct implementation --------------------------------------------
 
 
@@ -500,6 +536,45 @@ struct TemplateKeyValue
   TemplateVariant value;
 };
 
+/** @brief A variable reference like `a.b.0.c`, split into its parts once when
+ *  the template is parsed, so rendering does not need to split the name again
+ *  or compare field names as strings.
+ */
+class TemplateVariablePath
+{
+  public:
+    /** A part of the path after the first dot. */
+    struct Part
+    {
+      Part(const QCString &n,const QCString &r) : key(n), rest(r)
+      {
+        index = n.toInt(&isIndex);
+      }
+      TemplateKey key;        // for structs
+      QCString rest;          // this part and the parts following it, for warnings
+      bool isIndex = false;   // does the part represent a list index?
+      int index = 0;          // for lists
+    };
+    explicit TemplateVariablePath(const QCString &name) : m_name(name)
+    {
+      int i = name.find('.');
+      m_variable = (i==-1 ? name : name.left(i)).str();
+      while (i!=-1)
+      {
+        int s = i+1;
+        i = name.find('.',s);
+        m_parts.emplace_back(i==-1 ? name.mid(s) : name.mid(s,i-s),name.mid(s));
+      }
+    }
+    const QCString &name() const          { return m_name; }
+    const std::string &variable() const   { return m_variable; }
+    const std::vector<Part> &parts() const { return m_parts; }
+  private:
+    QCString m_name;
+    std::string m_variable;
+    std::vector<Part> m_parts;
+};
+
 /** @brief Internal class representing the implementation of a template
  *  context */
 class TemplateContextImpl : public TemplateContext
@@ -515,6 +590,8 @@ class TemplateContextImpl : public TemplateContext
     void update(const QCString &name,const TemplateVariant &v);
     TemplateVariant get(const QCString &name) const;
     const TemplateVariant *getRef(const QCString &name) const;
+    TemplateVariant get(const TemplateVariablePath &path) const;
+    const TemplateVariant *getRef(const std::string &name) const;
     void setOutputDirectory(const QCString &dir)
     { m_outputDir = dir; }
     void setEscapeIntf(const QCString &ext,TemplateEscapeIntf *intf)
@@ -529,6 +606,7 @@ class TemplateContextImpl : public TemplateContext
     }
     void setActiveEscapeIntf(TemplateEscapeIntf *intf) { m_activeEscapeIntf = intf; }
     void setSpacelessIntf(TemplateSpacelessIntf *intf) { m_spacelessIntf = intf; }
+    void setPageIntf(TemplatePageIntf *intf) { m_pageIntf = intf; }
 
     // internal methods
     TemplateBlockContext *blockContext();
@@ -559,12 +637,30 @@ class TemplateContextImpl : public TemplateContext
     void closeSubIndex(const QCString &indexName);
     void addIndexEntry(const QCString &indexName,const std::vector<TemplateKeyValue> &arguments);
 
+    // parallel rendering of created files
+    std::unique_ptr<TemplateContextImpl> copyForPage() const;
+    bool canRenderPagesInParallel() const;
+    void addPendingPage(std::future<void> &&page) { m_pendingPages.push_back(std::move(page)); }
+    void waitForPendingPages();
+    void enterRender() { m_renderDepth++; }
+    void leaveRender() { if (--m_renderDepth==0) waitForPendingPages(); }
+    size_t &cycleIndex(const void *cycleNode) { return m_cycleIndices[cycleNode]; }
+
+    // per file state, a created file does not depend on the files rendered before it
+    struct PageState
+    {
+      std::unordered_map<const void*,size_t> cycleIndices;
+      int pageIntfState = 0;
+    };
+    PageState enterPage();
+    void leavePage(PageState &&outer);
+
   private:
     const TemplateEngine *m_engine = 0;
     QCString m_templateName;
     int m_line = 0;
     QCString m_outputDir;
-    std::deque< std::map<std::string,TemplateVariant> > m_contextStack;
+    std::deque< std::unordered_map<std::string,TemplateVariant> > m_contextStack;
     TemplateBlockContext m_blockContext;
     std::unordered_map<std::string, TemplateEscapeIntf*> m_escapeIntfMap;
     TemplateEscapeIntf *m_activeEscapeIntf = 0;
@@ -575,6 +671,13 @@ class TemplateContextImpl : public TemplateContext
     std::unordered_map< std::string, std::stack<TemplateVariant> > m_indexStacks;
     QCString m_encoding;
     void *m_fromUtf8 = 0;
+    std::vector< std::unique_ptr<TemplateEscapeIntf> > m_ownedEscapeIntfs;
+    std::unique_ptr<TemplateSpacelessIntf> m_ownedSpacelessIntf;
+    std::unordered_map<const void*,size_t> m_cycleIndices;
+    TemplatePageIntf *m_pageIntf = 0;
+    std::vector< std::future<void> > m_pendingPages;
+    int m_renderDepth = 0;
+    bool m_isPageCopy = false;
 };
 
 //-----------------------------------------------------------------------------
@@ -1452,8 +1555,7 @@ class TemplateFilterFactory
 
     static TemplateFilterFactory *instance()
     {
-      static TemplateFilterFactory *instance = 0;
-      if (instance==0) instance = new TemplateFilterFactory;
+      static TemplateFilterFactory *instance = new TemplateFilterFactory;
       return instance;
     }
 
@@ -1551,13 +1653,13 @@ class ExprAstNumber : public ExprAst
 class ExprAstVariable : public ExprAst
 {
   public:
-    ExprAstVariable(const QCString &name) : m_name(name)
+    ExprAstVariable(const QCString &name) : m_name(name), m_path(name)
     { TRACE(("ExprAstVariable(%s)\n",name.data())); }
     const QCString &name() const { return m_name; }
     virtual TemplateVariant resolve(TemplateContext *c)
     {
-      TemplateVariant v = c->get(m_name);
       TemplateContextImpl *ci = dynamic_cast<TemplateContextImpl*>(c);
+      TemplateVariant v = ci ? ci->get(m_path) : c->get(m_name);
       if (!v.isValid())
       {
         if (ci) ci->warn(ci->templateName(),ci->line(),"undefined variable '%s' in expression",qPrint(m_name));
@@ -1566,6 +1668,7 @@ class ExprAstVariable : public ExprAst
     }
   private:
     QCString m_name;
+    TemplateVariablePath m_path;
 };
 
 class ExprAstFunctionVariable : public ExprAst
@@ -2445,9 +2548,72 @@ TemplateContextImpl::TemplateContextImpl(const TemplateEngine *e)
 
 TemplateContextImpl::~TemplateContextImpl()
 {
+  waitForPendingPages();
   pop();
 }
 
+/** Returns a context for rendering a created file on another thread. The copy
+ *  shares the variables and the indices with this context, but has its own scopes,
+ *  blocks and escape and spaceless state.
+ */
+std::unique_ptr<TemplateContextImpl> TemplateContextImpl::copyForPage() const
+{
+  auto ctx = std::make_unique<TemplateContextImpl>(m_engine);
+  ctx->m_isPageCopy   = true;
+  ctx->m_templateName = m_templateName;
+  ctx->m_line         = m_line;
+  ctx->m_outputDir    = m_outputDir;
+  ctx->m_contextStack = m_contextStack;
+  ctx->m_indices      = m_indices;
+  for (const auto &kv : m_escapeIntfMap)
+  {
+    ctx->m_ownedEscapeIntfs.push_back(kv.second->clone());
+    TemplateEscapeIntf *intf = ctx->m_ownedEscapeIntfs.back().get();
+    ctx->m_escapeIntfMap.insert(std::make_pair(kv.first,intf));
+    if (kv.second==m_activeEscapeIntf) ctx->m_activeEscapeIntf = intf;
+  }
+  if (m_spacelessIntf)
+  {
+    ctx->m_ownedSpacelessIntf = m_spacelessIntf->clone();
+    ctx->m_spacelessIntf = ctx->m_ownedSpacelessIntf.get();
+  }
+  ctx->m_spacelessEnabled = m_spacelessEnabled;
+  ctx->m_tabbingEnabled   = m_tabbingEnabled;
+  ctx->m_pageIntf         = m_pageIntf;
+  ctx->setEncoding(m_templateName,m_line,m_encoding);
+  return ctx;
+}
+
+bool TemplateContextImpl::canRenderPagesInParallel() const
+{
+  // files created from a copy are rendered in place, so a worker never waits for the pool
+  return !m_isPageCopy && Scheduler::instance().numThreads()>1;
+}
+
+TemplateContextImpl::PageState TemplateContextImpl::enterPage()
+{
+  PageState outer;
+  outer.cycleIndices = std::move(m_cycleIndices);
+  m_cycleIndices.clear();
+  if (m_pageIntf) outer.pageIntfState = m_pageIntf->enterPage();
+  return outer;
+}
+
+void TemplateContextImpl::leavePage(PageState &&outer)
+{
+  m_cycleIndices = std::move(outer.cycleIndices);
+  if (m_pageIntf) m_pageIntf->leavePage(outer.pageIntfState);
+}
+
+void TemplateContextImpl::waitForPendingPages()
+{
+  for (auto &page : m_pendingPages)
+  {
+    page.get();
+  }
+  m_pendingPages.clear();
+}
+
 void TemplateContextImpl::setEncoding(const QCString &templateName,int line,const QCString &enc)
 {
   if (enc==m_encoding) return; // nothing changed
@@ -2521,93 +2687,86 @@ void TemplateContextImpl::update(const QCString &name,const TemplateVariant &v)
 
 TemplateVariant TemplateContextImpl::get(const QCString &name) const
 {
-  int i=name.find('.');
-  if (i==-1) // simple name
+  if (name.find('.')==-1) // simple name
   {
     return getPrimary(name);
   }
   else // obj.prop
   {
-    QCString objName = name.left(i);
-    TemplateVariant v = getPrimary(objName);
-    QCString propName = name.mid(i+1);
-    while (!propName.isEmpty())
+    return get(TemplateVariablePath(name));
+  }
+}
+
+TemplateVariant TemplateContextImpl::get(const TemplateVariablePath &path) const
+{
+  const TemplateVariant *ref = getRef(path.variable());
+  TemplateVariant v = ref ? *ref : TemplateVariant();
+  QCString objName = path.variable().c_str();
+  const auto &parts = path.parts();
+  for (size_t i=0; i<parts.size(); i++)
+  {
+    const auto &part = parts[i];
+    bool last = i+1==parts.size();
+    //printf("get(%s) type=%zu:%s\n",qPrint(objName),v.type(),qPrint(v.toString()));
+    if (v.isStruct() || v.isWeakStruct())
     {
-      //printf("getPrimary(%s) type=%zu:%s\n",qPrint(objName),v.type(),qPrint(v.toString()));
-      if (v.isStruct() || v.isWeakStruct())
+      TemplateStructIntfPtr s = v.toStruct();
+      if (s)
       {
-        TemplateStructIntfPtr s = v.toStruct();
-        if (s)
+        v = s->lookup(part.key);
+        if (!v.isValid())
         {
-          i = propName.find(".");
-          int l = i==-1 ? propName.length() : i;
-          v = s->get(propName.left(l));
-          if (!v.isValid())
-          {
-            warn(m_templateName,m_line,"requesting non-existing property '%s' for object '%s'",qPrint(propName.left(l)),qPrint(objName));
-          }
-          if (i!=-1)
-          {
-            objName = propName.left(i);
-            propName = propName.mid(i+1);
-          }
-          else
-          {
-            propName.resize(0);
-          }
+          warn(m_templateName,m_line,"requesting non-existing property '%s' for object '%s'",qPrint(part.key.name()),qPrint(objName));
         }
-        else
+        if (!last)
         {
-          return TemplateVariant();
+          objName = part.key.name();
         }
       }
-      else if (v.isList() || v.isWeakList())
+      else
       {
-        TemplateListIntfPtr list = v.toList();
-        if (list)
+        return TemplateVariant();
+      }
+    }
+    else if (v.isList() || v.isWeakList())
+    {
+      TemplateListIntfPtr list = v.toList();
+      if (list)
+      {
+        if (part.isIndex)
         {
-          i = propName.find(".");
-          int l = i==-1 ? propName.length() : i;
-          bool b;
-          int index = propName.left(l).toInt(&b);
-          if (b)
-          {
-            v = list->at(index);
-          }
-          else
-          {
-            warn(m_templateName,m_line,"list index '%s' is not valid",qPrint(propName));
-            break;
-          }
-          if (i!=-1)
-          {
-            propName = propName.mid(i+1);
-          }
-          else
-          {
-            propName.resize(0);
-          }
+          v = list->at(part.index);
         }
         else
         {
-          return TemplateVariant();
+          warn(m_templateName,m_line,"list index '%s' is not valid",qPrint(part.rest));
+          break;
         }
       }
       else
       {
-        warn(m_templateName,m_line,"using . on an object '%s' is not an struct or list",qPrint(objName));
         return TemplateVariant();
       }
     }
-    return v;
+    else
+    {
+      warn(m_templateName,m_line,"using . on an object '%s' is not an struct or list",qPrint(objName));
+      return TemplateVariant();
+    }
   }
+  return v;
 }
 
 const TemplateVariant *TemplateContextImpl::getRef(const QCString &name) const
+{
+  return getRef(name.str());
+}
+
+const TemplateVariant *TemplateContextImpl::getRef(const std::string &name) const
 {
   for (const auto &ctx : m_contextStack)
   {
-    auto it = ctx.find(name.str());
+    auto it = ctx.find(name);
     if (it!=ctx.end())
     {
       return &it->second;
@@ -2624,7 +2783,7 @@ TemplateVariant TemplateContextImpl::getPrimary(const QCString &name) const
 
 void TemplateContextImpl::push()
 {
-  m_contextStack.push_front(std::map<std::string,TemplateVariant>());
+  m_contextStack.push_front(std::unordered_map<std::string,TemplateVariant>());
 }
 
 void TemplateContextImpl::pop()
@@ -3719,8 +3878,14 @@ class TemplateNodeCreate : public TemplateNodeCreator<TemplateNodeCreate>
       else
       {
         ExpressionParser ep(parser,line);
+        QCString templateArg = data.mid(i+6).stripWhiteSpace();
+        if (templateArg.right(9)==" parallel")
+        {
+          m_parallel = true;
+          templateArg = templateArg.left(templateArg.length()-9).stripWhiteSpace();
+        }
         m_fileExpr = ep.parse(data.left(i).stripWhiteSpace());
-        m_templateExpr = ep.parse(data.mid(i+6).stripWhiteSpace());
+        m_templateExpr = ep.parse(templateArg);
       }
     }
     void render(TextStream &, TemplateContext *c)
@@ -3762,23 +3927,25 @@ class TemplateNodeCreate : public TemplateNodeCreator<TemplateNodeCreate>
                 outputFile.prepend(ci->outputDirectory()+"/");
               }
               //printf("NoteCreate(%s)\n",qPrint(outputFile));
-              std::ofstream f(outputFile.str(),std::ofstream::out | std::ofstream::binary);
-              if (f.is_open())
+              if (m_parallel && ci->canRenderPagesInParallel())
               {
-                TextStream ts(&f);
-                TemplateEscapeIntf *escIntf = ci->escapeIntf();
-                ci->selectEscapeIntf(extension);
-                TextStream os;
-                createTemplate->render(os,c);
-                QCString out = os.str();
-                stripLeadingWhiteSpace(out);
-                ts << out;
+                // the page only reads the context, so render it on a copy while
+                // the current template continues
                 t->engine()->unload(t);
-                ci->setActiveEscapeIntf(escIntf);
+                std::shared_ptr<TemplateContextImpl> pageCtx = ci->copyForPage();
+                ci->addPendingPage(Scheduler::instance().threadPool().queue(
+                    [this,t,createTemplate,pageCtx,templateFile,outputFile,extension]()
+                    {
+                      t->engine()->setOutputExtension(extension);
+                      t->engine()->loadByName(templateFile,m_line); // cached, keeps the include context
+                      writeFile(createTemplate,pageCtx.get(),outputFile,extension);
+                      t->engine()->unload(t);
+                      t->engine()->setOutputExtension("");
+                    }));
               }
-              else
+              else if (writeFile(createTemplate,ci,outputFile,extension))
               {
-                ci->warn(m_templateName,m_line,"failed to open output file '%s' for create command",qPrint(outputFile));
+                t->engine()->unload(t);
               }
             }
             else
@@ -3792,8 +3959,32 @@ class TemplateNodeCreate : public TemplateNodeCreator<TemplateNodeCreate>
     }
 
   private:
+    bool writeFile(TemplateImpl *createTemplate,TemplateContextImpl *ci,
+                   const QCString &outputFile,const QCString &extension) const
+    {
+      std::ofstream f(outputFile.str(),std::ofstream::out | std::ofstream::binary);
+      if (!f.is_open())
+      {
+        ci->warn(m_templateName,m_line,"failed to open output file '%s' for create command",qPrint(outputFile));
+        return false;
+      }
+      TextStream ts(&f);
+      TemplateEscapeIntf *escIntf = ci->escapeIntf();
+      ci->selectEscapeIntf(extension);
+      TextStream os;
+      TemplateContextImpl::PageState outerPage = ci->enterPage();
+      createTemplate->render(os,ci);
+      ci->leavePage(std::move(outerPage));
+      QCString out = os.str();
+      stripLeadingWhiteSpace(out);
+      ts << out;
+      ci->setActiveEscapeIntf(escIntf);
+      return true;
+    }
+
     ExprAstPtr m_templateExpr;
     ExprAstPtr m_fileExpr;
+    bool m_parallel = false;
 };
 
 //----------------------------------------------------------
@@ -4119,7 +4310,6 @@ class TemplateNodeCycle : public TemplateNodeCreator<TemplateNodeCycle>
       : TemplateNodeCreator<TemplateNodeCycle>(parser,parent,line)
     {
       TRACE(("{TemplateNodeCycle(%s)\n",qPrint(data)));
-      m_index=0;
       ExpressionParser expParser(parser,line);
       std::vector<QCString> args = split(data," ");
       auto it = args.begin();
@@ -4143,9 +4333,10 @@ class TemplateNodeCycle : public TemplateNodeCreator<TemplateNodeCycle>
       TemplateContextImpl *ci = dynamic_cast<TemplateContextImpl*>(c);
       if (ci==0) return; // should not happen
       ci->setLocation(m_templateName,m_line);
-      if (m_index<m_args.size())
+      size_t &index = ci->cycleIndex(this); // per created file, see TemplateContextImpl::enterPage()
+      if (index<m_args.size())
       {
-        TemplateVariant v = m_args[m_index]->resolve(c);
+        TemplateVariant v = m_args[index]->resolve(c);
         if (v.isFunction())
         {
           v = v.call(std::vector<TemplateVariant>());
@@ -4173,13 +4364,12 @@ class TemplateNodeCycle : public TemplateNodeCreator<TemplateNodeCycle>
           }
         }
       }
-      if (++m_index==m_args.size()) // wrap around
+      if (++index==m_args.size()) // wrap around
       {
-        m_index=0;
+        index=0;
       }
     }
   private:
-    size_t m_index = 0;
     ExprAstList m_args;
 };
 
@@ -5065,8 +5255,10 @@ TemplateImpl::~TemplateImpl()
 
 void TemplateImpl::render(TextStream &ts, TemplateContext *c)
 {
+  ProfileScope profile("render template",m_name);
   TemplateContextImpl *ci = dynamic_cast<TemplateContextImpl*>(c);
   if (ci==0) return; // should not happen
+  ci->enterRender();
   if (!m_nodes.empty())
   {
     TemplateNodeExtend *ne = dynamic_cast<TemplateNodeExtend*>(m_nodes.front().get());
@@ -5084,6 +5276,7 @@ void TemplateImpl::render(TextStream &ts, TemplateContext *c)
     }
     m_nodes.render(ts,c);
   }
+  ci->leaveRender(); // the outermost template waits for the files it created in parallel
 }
 
 //----------------------------------------------------------
@@ -5117,7 +5310,9 @@ class TemplateEngine::Private
       //for (int i=0;i<m_indent;i++) printf("  ");
       //m_indent++;
       //printf("loadByName(%s,%d) {\n",qPrint(fileName),line);
-      m_includeStack.emplace_back(IncludeEntry::Template,fileName,QCString(),line);
+      ThreadState &state = threadState();
+      state.includeStack.emplace_back(IncludeEntry::Template,fileName,QCString(),line);
+      std::lock_guard<std::mutex> lock(m_cacheMutex);
       auto kv = m_templateCache.find(fileName.str());
       if (kv==m_templateCache.end()) // first time template is referenced
       {
@@ -5133,7 +5328,7 @@ class TemplateEngine::Private
           {
             kv = m_templateCache.insert(
                 std::make_pair(fileName.str(),
-                  std::make_unique<TemplateImpl>(m_engine,filePath,data,m_extension))).first;
+                  std::make_unique<TemplateImpl>(m_engine,filePath,data,state.extension))).first;
           }
         }
         else // fallback to default built-in template
@@ -5143,7 +5338,7 @@ class TemplateEngine::Private
           {
             kv = m_templateCache.insert(
                 std::make_pair(fileName.str(),
-                  std::make_unique<TemplateImpl>(m_engine,fileName,data,m_extension))).first;
+                  std::make_unique<TemplateImpl>(m_engine,fileName,data,state.extension))).first;
           }
           else
           {
@@ -5160,7 +5355,7 @@ class TemplateEngine::Private
       //m_indent--;
       //for (int i=0;i<m_indent;i++) printf("  ");
       //printf("}\n");
-      m_includeStack.pop_back();
+      threadState().includeStack.pop_back();
     }
 
     void enterBlock(const QCString &fileName,const QCString &blockName,int line)
@@ -5168,7 +5363,7 @@ class TemplateEngine::Private
       //for (int i=0;i<m_indent;i++) printf("  ");
       //m_indent++;
       //printf("enterBlock(%s,%s,%d) {\n",qPrint(fileName),qPrint(blockName),line);
-      m_includeStack.emplace_back(IncludeEntry::Block,fileName,blockName,line);
+      threadState().includeStack.emplace_back(IncludeEntry::Block,fileName,blockName,line);
     }
 
     void leaveBlock()
@@ -5176,17 +5371,18 @@ class TemplateEngine::Private
       //m_indent--;
       //for (int i=0;i<m_indent;i++) printf("  ");
       //printf("}\n");
-      m_includeStack.pop_back();
+      threadState().includeStack.pop_back();
     }
 
     void printIncludeContext(const QCString &fileName,int line) const
     {
-      auto it = m_includeStack.rbegin();
-      while (it!=m_includeStack.rend())
+      const std::vector<IncludeEntry> &includeStack = threadState().includeStack;
+      auto it = includeStack.rbegin();
+      while (it!=includeStack.rend())
       {
         const IncludeEntry &ie = *it;
         ++it;
-        const IncludeEntry *next = it!=m_includeStack.rend() ? &(*it) : 0;
+        const IncludeEntry *next = it!=includeStack.rend() ? &(*it) : 0;
         if (ie.type()==IncludeEntry::Template)
         {
           if (next)
@@ -5204,12 +5400,12 @@ class TemplateEngine::Private
 
     void setOutputExtension(const QCString &extension)
     {
-      m_extension = extension;
+      threadState().extension = extension;
     }
 
     QCString outputExtension() const
     {
-      return m_extension;
+      return threadState().extension;
     }
 
     void setTemplateDir(const QCString &dirName)
@@ -5218,11 +5414,26 @@ class TemplateEngine::Private
     }
 
   private:
+    /** Rendering state of a single thread; pages created with
+     *  `{% create ... parallel %}` are rendered on other threads.
+     */
+    struct ThreadState
+    {
+      std::vector<IncludeEntry> includeStack;
+      QCString extension;
+    };
+    ThreadState &threadState() const
+    {
+      std::lock_guard<std::mutex> lock(m_threadStateMutex);
+      return m_threadStates[std::this_thread::get_id()];
+    }
+
     std::unordered_map< std::string, std::unique_ptr<Template> > m_templateCache;
+    std::mutex m_cacheMutex;
     //mutable int m_indent;
     TemplateEngine *m_engine = 0;
-    std::vector<IncludeEntry> m_includeStack;
-    QCString m_extension;
+    mutable std::unordered_map< std::thread::id, ThreadState > m_threadStates;
+    mutable std::mutex m_threadStateMutex;
     QCString m_templateDirName;
 };
 
@@ -75,6 +75,10 @@ using TemplateStructIntfWeakPtr = std::weak_ptr<TemplateStructIntf>;
  *  Extension tags:
  *  - `create` which instantiates a template and writes the result to a file.
  *     The syntax is `{% create 'filename' from 'template' %}`.
+ *     Each created file starts with fresh `cycle` state.
+ *     With `{% create 'filename' from 'template' parallel %}` the file is
+ *     rendered on the thread pool while the rest of the template continues;
+ *     use this only for templates that do not add index entries.
  *  - `recursetree`
  *  - `markers`
  *  - `msg` ... `endmsg`
@@ -369,6 +373,30 @@ class TemplateList : public TemplateListIntf
 
 //------------------------------------------------------------------------
 
+/** @brief Interned name of a field of a struct.
+ *
+ *  Keys with the same name share the same id. The ids are small consecutive
+ *  numbers, so a struct can use them as an index in a table of fields instead
+ *  of comparing strings. Templates create the keys for the fields they access
+ *  when they are parsed.
+ */
+class TemplateKey
+{
+  public:
+    /** Creates the key for the field \a name. */
+    explicit TemplateKey(const QCString &name);
+
+    /** Returns the name of the field. */
+    const QCString &name() const { return m_name; }
+
+    /** Returns the id shared by all keys with the same name. */
+    size_t id() const { return m_id; }
+
+  private:
+    QCString m_name;
+    size_t   m_id;
+};
+
 /** @brief Abstract interface for a context value of type struct. */
 class TemplateStructIntf
 {
@@ -381,6 +409,11 @@ class TemplateStructIntf
      */
     virtual TemplateVariant get(const QCString &name) const = 0;
 
+    /** Gets the value for the field identified by \a key.
+     *  The default implementation calls get() with the name of the key.
+     */
+    virtual TemplateVariant lookup(const TemplateKey &key) const { return get(key.name()); }
+
     /** Return the list of fields. */
     virtual StringVector fields() const = 0;
 };
@@ -427,6 +460,8 @@ class TemplateEscapeIntf
     virtual QCString escape(const QCString &input) = 0;
     /** Setting tabbing mode on or off (for LaTeX) */
     virtual void enableTabbing(bool b) = 0;
+    /** Returns a copy of this object, for use by another thread */
+    virtual std::unique_ptr<TemplateEscapeIntf> clone() const = 0;
 };
 
 //------------------------------------------------------------------------
@@ -440,6 +475,23 @@ class TemplateSpacelessIntf
     virtual QCString remove(const QCString &input) = 0;
     /** Reset filter state */
     virtual void reset() = 0;
+    /** Returns a copy of this object, for use by another thread */
+    virtual std::unique_ptr<TemplateSpacelessIntf> clone() const = 0;
+};
+
+//------------------------------------------------------------------------
+
+/** @brief Interface used to keep state per file created with a create tag */
+class TemplatePageIntf
+{
+  public:
+    virtual ~TemplatePageIntf() {}
+    /** Called on the rendering thread before a created file is rendered.
+     *  Returns the state of the enclosing file, which is passed to leavePage().
+     */
+    virtual int enterPage() = 0;
+    /** Called after a created file is rendered to restore \a outerState */
+    virtual void leavePage(int outerState) = 0;
 };
 
 //------------------------------------------------------------------------
@@ -499,6 +551,11 @@ class TemplateContext
      *  to remove any redundant whitespace.
      */
     virtual void setSpacelessIntf(TemplateSpacelessIntf *intf) = 0;
+
+    /** Sets the interface that is notified when a created file is rendered,
+     *  so numbering inside a file does not depend on the other files.
+     */
+    virtual void setPageIntf(TemplatePageIntf *intf) = 0;
 };
 
 //------------------------------------------------------------------------
@@ -16,10 +16,13 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
-#include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
@@ -30,6 +33,11 @@
 /// Work can be queued by passing a function to queue(). A future will be
 /// returned that can be used to obtain the result of the function after execution.
 ///
+/// Each worker thread owns a queue of tasks. Tasks are distributed over the
+/// worker queues and a worker that runs out of work steals tasks from the
+/// other workers. Tasks with a higher priority are started before tasks with
+/// a lower priority that are queued at the same worker.
+///
 /// Usage example:
 /// @code
 /// ThreadPool pool(10);
@@ -48,17 +56,17 @@ class ThreadPool
 {
   public:
     /// start N threads in the thread pool.
-    ThreadPool(std::size_t N=1)
+    ThreadPool(std::size_t N=1) : m_size(std::max<std::size_t>(N,1))
     {
-      for (std::size_t i = 0; i < N; ++i)
+      m_workers.reserve(m_size);
+      for (std::size_t i = 0; i < m_size; ++i)
+      {
+        m_workers.push_back(std::make_unique<Worker>());
+      }
+      m_threads.reserve(m_size);
+      for (std::size_t i = 0; i < m_size; ++i)
       {
-        // each thread is a std::async running thread_task():
-        m_finished.push_back(
-            std::async(
-              std::launch::async,
-              [this]{ threadTask(); }
-              )
-            );
+        m_threads.emplace_back([this,i]{ threadTask(i); });
       }
     }
     /// deletes the thread pool by finishing all threads
@@ -69,83 +77,203 @@ class ThreadPool
 
     /// Queue the callable function \a f for the threads to execute.
     /// A future of the return type of the function is returned to capture the result.
+    /// Tasks with a higher \a priority are started first.
+    template<class F, class R=std::result_of_t<F&()> >
+    std::future<R> queue(F&& f,int priority=0)
+    {
+      std::packaged_task<R()> task(std::forward<F>(f));
+      auto r=task.get_future(); // get the return value before we hand off the task
+      push(nextWorker(),Task(std::move(task),priority));
+      notify(1);
+      return r; // return the future result of the task
+    }
+
+    /// Queue a batch of callable functions \a funcs for the threads to execute.
+    /// The optional vector \a priorities gives the priority for each function.
+    /// The futures are returned in the same order as the functions.
     template<class F, class R=std::result_of_t<F&()> >
-    std::future<R> queue(F&& f)
+    std::vector< std::future<R> > queueBatch(std::vector<F> &funcs,
+                                             const std::vector<int> &priorities=std::vector<int>())
     {
-      // We wrap the function object into a packaged task, splitting
-      // execution from the return value.
-      // Since the packaged_task object is not copyable, we create it on the heap
-      // and capture it via a shared pointer in a lambda and then assign that lambda
-      // to a std::function.
-      auto ptr = std::make_shared< std::packaged_task<R()> >(std::forward<F>(f));
-      auto taskFunc = [ptr]() { if (ptr->valid()) (*ptr)(); };
-
-      auto r=ptr->get_future(); // get the return value before we hand off the task
+      std::vector< std::future<R> > results;
+      results.reserve(funcs.size());
+      std::vector<Task> tasks;
+      tasks.reserve(funcs.size());
+      for (std::size_t i=0; i<funcs.size(); i++)
       {
-        std::unique_lock<std::mutex> l(m_mutex);
-        m_work.emplace_back(taskFunc);
-        m_cond.notify_one(); // wake a thread to work on the task
+        std::packaged_task<R()> task(std::move(funcs[i]));
+        results.push_back(task.get_future());
+        tasks.emplace_back(std::move(task),i<priorities.size() ? priorities[i] : 0);
       }
-
-      return r; // return the future result of the task
+      // hand out the tasks in order of decreasing priority, so each
+      // worker queue is sorted as well and the most important work starts first.
+      std::stable_sort(tasks.begin(),tasks.end(),
+          [](const Task &t1,const Task &t2) { return t1.priority() > t2.priority(); });
+      std::size_t first = nextWorker();
+      for (std::size_t i=0; i<tasks.size(); i++)
+      {
+        push((first+i)%m_size,std::move(tasks[i]));
+      }
+      notify(tasks.size());
+      return results;
     }
 
-    /// finish enques a "stop the thread" message for every thread,
-    /// then waits for them to finish
+    /// finish waits until all queued tasks are done and then stops the threads
     void finish()
     {
       {
-        std::unique_lock<std::mutex> l(m_mutex);
-        for(auto&& u : m_finished)
-        {
-          unused_variable(u);
-          m_work.push_back({}); // insert empty function object to signal abort
-        }
+        std::lock_guard<std::mutex> l(m_sleepMutex);
+        m_stop = true;
       }
-      m_cond.notify_all();
-      m_finished.clear();
+      m_sleepCond.notify_all();
+      for (auto &t : m_threads)
+      {
+        if (t.joinable()) t.join();
+      }
+      m_threads.clear();
+    }
+
+    /// returns the number of worker threads in the pool
+    std::size_t size() const { return m_size; }
+
+    /// returns the total time in seconds the worker threads spent executing tasks
+    double busyTime() const
+    {
+      return static_cast<double>(m_busyTime.load())/1000000.0;
     }
   private:
 
-    // helper to silence the compiler warning about unused variables
-    template <typename ...Args>
-    void unused_variable(Args&& ...args) { (void)(sizeof...(args)); }
+    /// Move-only type erased unit of work with a priority.
+    class Task
+    {
+      public:
+        Task() = default;
+        template<class F>
+        Task(F &&f,int priority) : m_impl(std::make_unique<Model<F>>(std::forward<F>(f))), m_priority(priority) {}
+        void operator()() { m_impl->run(); }
+        int priority() const { return m_priority; }
+      private:
+        struct Concept
+        {
+          virtual ~Concept() {}
+          virtual void run() = 0;
+        };
+        template<class F>
+        struct Model : public Concept
+        {
+          Model(F &&f) : m_f(std::move(f)) {}
+          void run() override { m_f(); }
+          F m_f;
+        };
+        std::unique_ptr<Concept> m_impl;
+        int m_priority = 0;
+    };
+
+    /// The queue of tasks owned by a single worker thread.
+    /// The owner takes tasks from the front, thieves take them from the back.
+    struct Worker
+    {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    std::size_t nextWorker()
+    {
+      return m_nextWorker++ % m_size;
+    }
+
+    // adds a task to the queue of worker w, keeping the queue sorted on priority
+    void push(std::size_t w,Task &&task)
+    {
+      Worker &worker = *m_workers[w];
+      std::lock_guard<std::mutex> l(worker.mutex);
+      auto it = worker.tasks.end();
+      while (it!=worker.tasks.begin() && std::prev(it)->priority()<task.priority())
+      {
+        --it;
+      }
+      worker.tasks.insert(it,std::move(task));
+    }
+
+    // registers n new tasks and wakes up the threads to work on them
+    void notify(std::size_t n)
+    {
+      {
+        std::lock_guard<std::mutex> l(m_sleepMutex);
+        m_pending+=n;
+      }
+      if (n==1) m_sleepCond.notify_one(); else m_sleepCond.notify_all();
+    }
+
+    // tries to get a task for worker w, first from its own queue, then from the others
+    bool pop(std::size_t w,Task &task)
+    {
+      {
+        Worker &worker = *m_workers[w];
+        std::lock_guard<std::mutex> l(worker.mutex);
+        if (!worker.tasks.empty())
+        {
+          task = std::move(worker.tasks.front());
+          worker.tasks.pop_front();
+          return true;
+        }
+      }
+      for (std::size_t i=1; i<m_size; i++)
+      {
+        Worker &victim = *m_workers[(w+i)%m_size];
+        std::lock_guard<std::mutex> l(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+          task = std::move(victim.tasks.back());
+          victim.tasks.pop_back();
+          return true;
+        }
+      }
+      return false;
+    }
 
     // the work that a worker thread does:
-    void threadTask()
+    void threadTask(std::size_t w)
     {
       while(true)
       {
-        // pop a task off the queue:
-        std::function<void()> f;
         {
-          // usual thread-safe queue code:
-          std::unique_lock<std::mutex> l(m_mutex);
-          if (m_work.empty())
-          {
-            m_cond.wait(l,[&]{return !m_work.empty();});
-          }
-          f = std::move(m_work.front());
-          m_work.pop_front();
+          // sleep until there is work or we are asked to stop
+          std::unique_lock<std::mutex> l(m_sleepMutex);
+          m_sleepCond.wait(l,[&]{return m_pending>0 || m_stop;});
+          if (m_pending==0) return; // stopped and all work is done
+        }
+        Task task;
+        if (pop(w,task))
+        {
+          m_pending--;
+          // run the task
+          auto startTime = std::chrono::steady_clock::now();
+          task();
+          auto endTime = std::chrono::steady_clock::now();
+          m_busyTime += static_cast<uint64_t>(std::chrono::duration_cast<
+                            std::chrono::microseconds>(endTime - startTime).count());
+        }
+        else
+        {
+          // another thread took the task that woke us up
+          std::this_thread::yield();
         }
-        // if the function is empty, it means we are asked to abort
-        if (!f) return;
-        // run the task
-        f();
       }
     }
 
-    // the mutex, condition variable and deque form a single
-    // thread-safe triggered queue of tasks:
-    std::mutex m_mutex;
-    std::condition_variable m_cond;
+    std::size_t m_size;
+    std::vector< std::unique_ptr<Worker> > m_workers;
+    std::vector< std::thread > m_threads;
+    std::atomic<std::size_t> m_nextWorker { 0 };
 
-    // hold the queue of work
-    std::deque< std::function<void()> > m_work;
+    // the mutex and condition variable used to let idle threads sleep
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCond;
+    std::atomic<std::size_t> m_pending { 0 };
+    bool m_stop = false;
 
-    // this holds futures representing the worker threads being done:
-    std::vector< std::future<void> > m_finished;
+    std::atomic<uint64_t> m_busyTime { 0 };
 };
 
 #endif
-
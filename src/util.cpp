@@ -73,6 +73,8 @@
 #include "dir.h"
 #include "utf8.h"
 #include "textstream.h"
+#include "filecontentcache.h"
+#include "filtercache.h"
 
 #define ENABLE_TRACINGSUPPORT 0
 
@@ -1399,7 +1401,7 @@ QCString transcodeCharacterStringToUTF8(const QCString &input)
  *  is TRUE the file will be filtered by any user specified input filter.
  *  If \a name is "-" the string will be read from standard input.
  */
-QCString fileToString(const QCString &name,bool filter,bool isSourceCode)
+QCString fileToString(const QCString &name,bool filter,bool isSourceCode,bool isInput)
 {
   if (name.isEmpty()) return QCString();
   bool fileOpened=false;
@@ -1423,7 +1425,7 @@ QCString fileToString(const QCString &name,bool filter,bool isSourceCode)
       return "";
     }
     BufStr buf((uint)fi.size());
-    fileOpened=readInputFile(name,buf,filter,isSourceCode);
+    fileOpened=readInputFile(name,buf,filter,isSourceCode,isInput);
     if (fileOpened)
     {
       int s = buf.size();
@@ -6123,11 +6125,13 @@ void stackTrace()
 #endif
 }
 
-static int transcodeCharacterBuffer(const QCString &fileName,BufStr &srcBuf,int size,
-           const QCString &inputEncoding,const QCString &outputEncoding)
+/*! Converts the \a size bytes at \a src from \a inputEncoding to \a outputEncoding
+ *  and appends the result to \a dst. The output grows while the conversion proceeds,
+ *  so no buffer for the worst case output size is needed.
+ */
+static void transcodeCharacters(const QCString &fileName,const char *src,size_t size,
+           const QCString &inputEncoding,const QCString &outputEncoding,std::string &dst)
 {
-  if (inputEncoding.isEmpty() || outputEncoding.isEmpty()) return size;
-  if (qstricmp(inputEncoding,outputEncoding)==0) return size;
   void *cd = portable_iconv_open(outputEncoding.data(),inputEncoding.data());
   if (cd==(void *)(-1))
   {
@@ -6135,121 +6139,171 @@ static int transcodeCharacterBuffer(const QCString &fileName,BufStr &srcBuf,int
         "Check the INPUT_ENCODING setting in the config file!\n",
         qPrint(inputEncoding),qPrint(outputEncoding),strerror(errno));
   }
-  int tmpBufSize=size*4+1;
-  BufStr tmpBuf(tmpBufSize);
-  size_t iLeft=size;
-  size_t oLeft=tmpBufSize;
-  const char *srcPtr = srcBuf.data();
-  char *dstPtr = tmpBuf.data();
-  uint newSize=0;
-  if (!portable_iconv(cd, &srcPtr, &iLeft, &dstPtr, &oLeft))
+  size_t dstPos = dst.size();
+  dst.resize(dstPos+size+size/2+16);
+  const char *srcPtr = src;
+  size_t iLeft = size;
+  for (;;)
   {
-    newSize = tmpBufSize-(int)oLeft;
-    srcBuf.shrink(newSize);
-    strncpy(srcBuf.data(),tmpBuf.data(),newSize);
-    //printf("iconv: input size=%d output size=%d\n[%s]\n",size,newSize,qPrint(srcBuf));
+    char *dstPtr = &dst[dstPos];
+    size_t oLeft = dst.size()-dstPos;
+    size_t result = portable_iconv(cd, &srcPtr, &iLeft, &dstPtr, &oLeft);
+    dstPos = dst.size()-oLeft;
+    if (result==static_cast<size_t>(-1) && errno==E2BIG) // output buffer full
+    {
+      dst.resize(dst.size()+2*iLeft+4096);
+    }
+    else if (result!=0)
+    {
+      term("%s: failed to translate characters from %s to %s: check INPUT_ENCODING\n",
+          qPrint(fileName),qPrint(inputEncoding),qPrint(outputEncoding));
+    }
+    else
+    {
+      break;
+    }
   }
-  else
+  dst.resize(dstPos);
+  portable_iconv_close(cd);
+}
+
+//! returns TRUE if filterCRLF() would change the \a len bytes at \a buf
+static bool needsCRLFFilter(const char *buf,size_t len)
+{
+  for (size_t i=0;i<len;i++)
   {
-    term("%s: failed to translate characters from %s to %s: check INPUT_ENCODING\n",
-        qPrint(fileName),qPrint(inputEncoding),qPrint(outputEncoding));
+    char c = buf[i];
+    if (c=='\r' || (c=='\0' && i+2<len)) return TRUE;
   }
-  portable_iconv_close(cd);
-  return newSize;
+  return FALSE;
 }
 
-//! read a file name \a fileName and optionally filter and transcode it
-bool readInputFile(const QCString &fileName,BufStr &inBuf,bool filter,bool isSourceCode)
+//! runs filter \a filterName on file \a fileName and stores its output in \a output
+static bool runInputFilter(const QCString &fileName,const QCString &filterName,std::string &output)
 {
-  // try to open file
-  int size=0;
+  FilterCache &filterCache = FilterCache::instance();
+  QCString cacheKey = filterCache.key(filterName,fileName);
+  if (cacheKey.isEmpty() || !filterCache.load(cacheKey,output)) // no output of a previous run
+  {
+    QCString cmd=filterName+" \""+fileName+"\"";
+    Debug::print(Debug::ExtCmd,0,"Executing popen(`%s`)\n",qPrint(cmd));
+    FILE *f=Portable::popen(cmd,"r");
+    if (!f)
+    {
+      err("could not execute filter %s\n",qPrint(filterName));
+      return FALSE;
+    }
+    const int bufSize=4096;
+    char buf[bufSize];
+    size_t numRead;
+    while ((numRead=fread(buf,1,bufSize,f))>0)
+    {
+      output.append(buf,numRead);
+    }
+    if (Portable::pclose(f)==0) // only keep the output of successful runs
+    {
+      filterCache.store(cacheKey,output.data(),output.size());
+    }
+  }
+  Debug::print(Debug::FilterOutput, 0, "Filter output\n");
+  Debug::print(Debug::FilterOutput,0,"-------------\n%s\n-------------\n",output.c_str());
+  return TRUE;
+}
 
-  FileInfo fi(fileName.str());
-  if (!fi.exists()) return FALSE;
-  QCString filterName = getFileFilter(fileName,isSourceCode);
-  if (filterName.isEmpty() || !filter)
+/*! Reads file \a fileName, filters it with \a filterName (if not empty), and
+ *  converts it to UTF-8 with LF line endings.
+ */
+static FileContentCache::Contents readFileContents(const QCString &fileName,const FileInfo &fi,const QCString &filterName)
+{
+  std::shared_ptr<FileContents> raw;
+  if (filterName.isEmpty())
   {
     std::ifstream f(fileName.str(),std::ifstream::in | std::ifstream::binary);
     if (!f.is_open())
     {
       err("could not open file %s\n",qPrint(fileName));
-      return FALSE;
+      return nullptr;
     }
-    size=(int)fi.size();
-    // read the file
-    inBuf.skip(size);
-    f.read(inBuf.data(),size);
+    std::string contents(fi.size(),'\0');
+    f.read(&contents[0],static_cast<std::streamsize>(contents.size()));
     if (f.fail())
     {
       err("problems while reading file %s\n",qPrint(fileName));
-      return FALSE;
+      return nullptr;
     }
+    raw = std::make_shared<FileContents>(std::move(contents));
   }
   else
   {
-    QCString cmd=filterName+" \""+fileName+"\"";
-    Debug::print(Debug::ExtCmd,0,"Executing popen(`%s`)\n",qPrint(cmd));
-    FILE *f=Portable::popen(cmd,"r");
-    if (!f)
-    {
-      err("could not execute filter %s\n",qPrint(filterName));
-      return FALSE;
-    }
-    const int bufSize=1024;
-    char buf[bufSize];
-    int numRead;
-    while ((numRead=(int)fread(buf,1,bufSize,f))>0)
-    {
-      //printf(">>>>>>>>Reading %d bytes\n",numRead);
-      inBuf.addArray(buf,numRead),size+=numRead;
-    }
-    Portable::pclose(f);
-    inBuf.at(inBuf.curPos()) ='\0';
-    Debug::print(Debug::FilterOutput, 0, "Filter output\n");
-    Debug::print(Debug::FilterOutput,0,"-------------\n%s\n-------------\n",qPrint(inBuf));
+    std::string output;
+    if (!runInputFilter(fileName,filterName,output)) return nullptr;
+    raw = std::make_shared<FileContents>(std::move(output));
   }
 
-  int start=0;
-  if (size>=2 &&
-      ((uchar)inBuf.at(0)==0xFF && (uchar)inBuf.at(1)==0xFE) // Little endian BOM
-     ) // UCS-2LE encoded file
+  const uchar *p = reinterpret_cast<const uchar *>(raw->data());
+  size_t size = raw->size();
+  QCString encoding;
+  if (size>=2 && p[0]==0xFF && p[1]==0xFE) // Little endian BOM
   {
-    transcodeCharacterBuffer(fileName,inBuf,inBuf.curPos(),
-        "UCS-2LE","UTF-8");
+    encoding = "UCS-2LE";
   }
-  else if (size>=2 &&
-           ((uchar)inBuf.at(0)==0xFE && (uchar)inBuf.at(1)==0xFF) // big endian BOM
-         ) // UCS-2BE encoded file
+  else if (size>=2 && p[0]==0xFE && p[1]==0xFF) // big endian BOM
   {
-    transcodeCharacterBuffer(fileName,inBuf,inBuf.curPos(),
-        "UCS-2BE","UTF-8");
+    encoding = "UCS-2BE";
   }
-  else if (size>=3 &&
-           (uchar)inBuf.at(0)==0xEF &&
-           (uchar)inBuf.at(1)==0xBB &&
-           (uchar)inBuf.at(2)==0xBF
-     ) // UTF-8 encoded file
+  else if (size>=3 && p[0]==0xEF && p[1]==0xBB && p[2]==0xBF) // UTF-8 encoded file
   {
-    inBuf.dropFromStart(3); // remove UTF-8 BOM: no translation needed
+    raw->skip(3); // remove UTF-8 BOM: no translation needed
   }
   else // transcode according to the INPUT_ENCODING setting
   {
-    // do character transcoding if needed.
-    transcodeCharacterBuffer(fileName,inBuf,inBuf.curPos(),
-        Config_getString(INPUT_ENCODING),"UTF-8");
+    encoding = Config_getString(INPUT_ENCODING);
   }
+  bool transcode = !encoding.isEmpty() && qstricmp(encoding,"UTF-8")!=0;
 
-  //inBuf.addChar('\n'); /* to prevent problems under Windows ? */
+  if (!transcode && !needsCRLFFilter(raw->data(),raw->size()))
+  {
+    return raw; // nothing to convert
+  }
+  std::string result;
+  if (transcode)
+  {
+    transcodeCharacters(fileName,raw->data(),raw->size(),encoding,"UTF-8",result);
+  }
+  else
+  {
+    result.assign(raw->data(),raw->size());
+  }
+  raw.reset();
 
   // and translate CR's
-  size=inBuf.curPos()-start;
-  int newSize=filterCRLF(inBuf.data()+start,size);
-  //printf("filter char at %p size=%d newSize=%d\n",qPrint(dest)+oldPos,size,newSize);
-  if (newSize!=size) // we removed chars
+  result.resize(static_cast<size_t>(filterCRLF(&result[0],static_cast<int>(result.size()))));
+  return std::make_shared<FileContents>(std::move(result));
+}
+
+/*! read a file name \a fileName and optionally filter and transcode it.
+ *  Files that are filtered, read as source code or marked with \a isInput
+ *  are part of the input, so their contents are cached.
+ */
+bool readInputFile(const QCString &fileName,BufStr &inBuf,bool filter,bool isSourceCode,bool isInput)
+{
+  FileInfo fi(fileName.str());
+  if (!fi.exists()) return FALSE;
+  QCString filterName = filter ? getFileFilter(fileName,isSourceCode) : QCString();
+  auto reader = [&fileName,&fi,&filterName]() { return readFileContents(fileName,fi,filterName); };
+  FileContentCache::Contents contents;
+  if (!filter && !isSourceCode && !isInput)
+  {
+    // not read as input or source file, e.g. a header template or a file
+    // produced during the run, so do not cache it.
+    contents = reader();
+  }
+  else
   {
-    inBuf.shrink(newSize); // resize the array
-    //printf(".......resizing from %d to %d result=[%s]\n",oldPos+size,oldPos+newSize,qPrint(dest));
+    contents = FileContentCache::instance().get(fi,filterName,reader);
   }
+  if (!contents) return FALSE;
+  inBuf.addArray(contents->data(),static_cast<uint>(contents->size()));
   inBuf.addChar(0);
   return TRUE;
 }
@@ -6282,45 +6336,102 @@ QCString filterTitle(const QCString &title)
 
 bool patternMatch(const FileInfo &fi,const StringVector &patList)
 {
-  bool caseSenseNames = Config_getBool(CASE_SENSE_NAMES);
-  bool found = FALSE;
+  return FilePatternMatcher(patList).match(fi);
+}
+
+struct FilePatternMatcher::Private
+{
+  bool caseSenseNames = true;
+  StringUnorderedSet names;                             // patterns without wildcards
+  StringUnorderedSet suffixes;                          // patterns of the form '*suffix', without the '*'
+  std::vector<size_t> suffixLengths;                    // distinct lengths of the suffixes
+  std::vector< std::unique_ptr<reg::Ex> > expressions;  // all other patterns
+
+  bool matchName(const std::string &name) const
+  {
+    if (names.find(name)!=names.end()) return true;
+    for (size_t len : suffixLengths)
+    {
+      if (len<=name.length() && suffixes.find(name.substr(name.length()-len))!=suffixes.end())
+      {
+        return true;
+      }
+    }
+    for (const auto &re : expressions)
+    {
+      if (reg::match(name,*re)) return true;
+    }
+    return false;
+  }
+};
+
+FilePatternMatcher::FilePatternMatcher(const StringVector &patList) : p(std::make_unique<Private>())
+{
+  p->caseSenseNames = Config_getBool(CASE_SENSE_NAMES);
 
   // For platforms where the file system is non case sensitive overrule the setting
   if (!Portable::fileSystemIsCaseSensitive())
   {
-    caseSenseNames = FALSE;
+    p->caseSenseNames = FALSE;
   }
 
-  if (!patList.empty())
+  for (auto pattern: patList)
   {
-    std::string fn = fi.fileName();
-    std::string fp = fi.filePath();
-    std::string afp= fi.absFilePath();
+    if (pattern.empty()) continue;
+    size_t i=pattern.find('=');
+    if (i!=std::string::npos) pattern=pattern.substr(0,i); // strip of the extension specific filter name
+    if (!p->caseSenseNames)
+    {
+      pattern = QCString(pattern).lower().str();
+    }
 
-    for (auto pattern: patList)
+    bool hasWildcards = pattern.find_first_of("*?[")!=std::string::npos;
+    bool isSuffix     = !pattern.empty() && pattern[0]=='*' && pattern.find_first_of("*?[",1)==std::string::npos;
+    if (!hasWildcards)
     {
-      if (!pattern.empty())
+      p->names.insert(pattern);
+    }
+    else if (isSuffix)
+    {
+      std::string suffix = pattern.substr(1);
+      p->suffixes.insert(suffix);
+      if (std::find(p->suffixLengths.begin(),p->suffixLengths.end(),suffix.length())==p->suffixLengths.end())
       {
-        size_t i=pattern.find('=');
-        if (i!=std::string::npos) pattern=pattern.substr(0,i); // strip of the extension specific filter name
-
-        if (!caseSenseNames)
-        {
-          pattern = QCString(pattern).lower().str();
-          fn      = QCString(fn).lower().str();
-          fp      = QCString(fp).lower().str();
-          afp     = QCString(afp).lower().str();
-        }
-        reg::Ex re(pattern,reg::Ex::Mode::Wildcard);
-        found = re.isValid() && (reg::match(fn,re) ||
-                                 (fn!=fp && reg::match(fp,re)) ||
-                                 (fn!=afp && fp!=afp && reg::match(afp,re)));
-        if (found) break;
-        //printf("Matching '%s' against pattern '%s' found=%d\n",
-        //    qPrint(fi->fileName()),qPrint(pattern),found);
+        p->suffixLengths.push_back(suffix.length());
+      }
+    }
+    else
+    {
+      auto re = std::make_unique<reg::Ex>(pattern,reg::Ex::Mode::Wildcard);
+      if (re->isValid())
+      {
+        p->expressions.push_back(std::move(re));
       }
     }
   }
+}
+
+FilePatternMatcher::~FilePatternMatcher()
+{
+}
+
+bool FilePatternMatcher::match(const FileInfo &fi) const
+{
+  if (p->names.empty() && p->suffixes.empty() && p->expressions.empty()) return false;
+
+  std::string fn = fi.fileName();
+  std::string fp = fi.filePath();
+  std::string afp= fi.absFilePath();
+  if (!p->caseSenseNames)
+  {
+    fn  = QCString(fn).lower().str();
+    fp  = QCString(fp).lower().str();
+    afp = QCString(afp).lower().str();
+  }
+  bool found = p->matchName(fn) ||
+               (fn!=fp && p->matchName(fp)) ||
+               (fn!=afp && fp!=afp && p->matchName(afp));
+  //printf("Matching '%s' found=%d\n",qPrint(fi.fileName()),found);
   return found;
 }
 
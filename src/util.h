@@ -101,7 +101,7 @@ void linkifyText(const TextGeneratorIntf &ol,
                  int indentLevel=0
                 );
 
-QCString fileToString(const QCString &name,bool filter=FALSE,bool isSourceCode=FALSE);
+QCString fileToString(const QCString &name,bool filter=FALSE,bool isSourceCode=FALSE,bool isInput=FALSE);
 
 QCString dateToString(bool);
 
@@ -360,11 +360,35 @@ QCString convertCharEntitiesToUTF8(const QCString &s);
 void stackTrace();
 
 bool readInputFile(const QCString &fileName,BufStr &inBuf,
-                   bool filter=TRUE,bool isSourceCode=FALSE);
+                   bool filter=TRUE,bool isSourceCode=FALSE,bool isInput=FALSE);
 QCString filterTitle(const QCString &title);
 
 bool patternMatch(const FileInfo &fi,const StringVector &patList);
 
+/** @brief Matches file names against a list of wildcard patterns, such as FILE_PATTERNS.
+ *
+ *  The patterns are analyzed once, so a matcher can be reused for all entries of a
+ *  directory walk. Patterns of the form `*suffix` (like `*.cpp`) and patterns
+ *  without wildcards are looked up in hash sets; only the remaining patterns
+ *  are matched with a regular expression. A file matches under the same conditions
+ *  as for patternMatch().
+ */
+class FilePatternMatcher
+{
+  public:
+    explicit FilePatternMatcher(const StringVector &patList);
+   ~FilePatternMatcher();
+    FilePatternMatcher(const FilePatternMatcher &) = delete;
+    FilePatternMatcher &operator=(const FilePatternMatcher &) = delete;
+
+    /** Returns TRUE if the name or path of \a fi matches one of the patterns. */
+    bool match(const FileInfo &fi) const;
+
+  private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
 QCString externalLinkTarget(const bool parent = false);
 QCString externalRef(const QCString &relPath,const QCString &ref,bool href);
 int nextUtf8CharPosition(const QCString &utf8Str,uint len,uint startPos);
@@ -47,6 +47,8 @@
 #include "resourcemgr.h"
 #include "dir.h"
 #include "utf8.h"
+#include "scheduler.h"
+#include "threadpool.h"
 
 // no debug info
 #define XML_DB(x) do {} while(0)
@@ -455,7 +457,9 @@ void writeXMLCodeBlock(TextStream &t,FileDef *fd)
                 -1,          // endLine
                 FALSE,       // inlineFragment
                 0,           // memberDef
-                TRUE         // showLineNumbers
+                TRUE,        // showLineNumbers
+                0,           // searchCtx
+                FALSE        // collectXRefs, file compounds are written in parallel
                 );
   xmlGen->endCodeFragment("DoxyCode");
   xmlGen->finish();
@@ -1885,6 +1889,48 @@ static void generateXMLForPage(PageDef *pd,TextStream &ti,bool isExample)
   ti << "  </compound>\n";
 }
 
+/** Runs the generators in \a compounds, using the shared thread pool when
+ *  multiple threads are configured. Returns the index entries produced by
+ *  the generators, in the same order as the generators.
+ */
+static std::vector<std::string> generateXMLCompounds(
+             const std::vector< std::function<void(TextStream &)> > &compounds)
+{
+  std::vector<std::string> entries;
+  entries.reserve(compounds.size());
+  std::size_t numThreads = Scheduler::instance().numThreads();
+  if (numThreads>1 && compounds.size()>1) // multi threaded processing
+  {
+    std::vector< std::function<std::string()> > tasks;
+    tasks.reserve(compounds.size());
+    for (const auto &compound : compounds)
+    {
+      tasks.push_back([&compound]()
+      {
+        TextStream ti;
+        compound(ti);
+        return ti.str();
+      });
+    }
+    ThreadPool &threadPool = Scheduler::instance().threadPool();
+    auto results = threadPool.queueBatch(tasks);
+    for (auto &f : results)
+    {
+      entries.push_back(f.get());
+    }
+  }
+  else // single threaded processing
+  {
+    for (const auto &compound : compounds)
+    {
+      TextStream ti;
+      compound(ti);
+      entries.push_back(ti.str());
+    }
+  }
+  return entries;
+}
+
 void generateXML()
 {
   // + classes
@@ -1972,52 +2018,87 @@ void generateXML()
     t << "xml:lang=\"" << theTranslator->trISOLang() << "\"";
     t << ">\n";
 
+    // Every compound writes its own XML file and an entry for the index.
+    // The compounds are generated in parallel, the entries are collected
+    // per compound and written to the index in the original order.
+    std::vector< std::function<void(TextStream &)> > compounds;
     for (const auto &cd : *Doxygen::classLinkedMap)
     {
-      generateXMLForClass(cd.get(),t);
+      compounds.push_back([cd=cd.get()](TextStream &ti)
+      {
+        generateXMLForClass(cd,ti);
+      });
     }
     for (const auto &cd : *Doxygen::conceptLinkedMap)
     {
-      msg("Generating XML output for concept %s\n",qPrint(cd->name()));
-      generateXMLForConcept(cd.get(),t);
+      compounds.push_back([cd=cd.get()](TextStream &ti)
+      {
+        msg("Generating XML output for concept %s\n",qPrint(cd->name()));
+        generateXMLForConcept(cd,ti);
+      });
     }
     for (const auto &nd : *Doxygen::namespaceLinkedMap)
     {
-      msg("Generating XML output for namespace %s\n",qPrint(nd->name()));
-      generateXMLForNamespace(nd.get(),t);
+      compounds.push_back([nd=nd.get()](TextStream &ti)
+      {
+        msg("Generating XML output for namespace %s\n",qPrint(nd->name()));
+        generateXMLForNamespace(nd,ti);
+      });
     }
     for (const auto &fn : *Doxygen::inputNameLinkedMap)
     {
       for (const auto &fd : *fn)
       {
-        msg("Generating XML output for file %s\n",qPrint(fd->name()));
-        generateXMLForFile(fd.get(),t);
+        compounds.push_back([fd=fd.get()](TextStream &ti)
+        {
+          msg("Generating XML output for file %s\n",qPrint(fd->name()));
+          generateXMLForFile(fd,ti);
+        });
       }
     }
     for (const auto &gd : *Doxygen::groupLinkedMap)
     {
-      msg("Generating XML output for group %s\n",qPrint(gd->name()));
-      generateXMLForGroup(gd.get(),t);
+      compounds.push_back([gd=gd.get()](TextStream &ti)
+      {
+        msg("Generating XML output for group %s\n",qPrint(gd->name()));
+        generateXMLForGroup(gd,ti);
+      });
     }
     for (const auto &pd : *Doxygen::pageLinkedMap)
     {
-      msg("Generating XML output for page %s\n",qPrint(pd->name()));
-      generateXMLForPage(pd.get(),t,FALSE);
+      compounds.push_back([pd=pd.get()](TextStream &ti)
+      {
+        msg("Generating XML output for page %s\n",qPrint(pd->name()));
+        generateXMLForPage(pd,ti,FALSE);
+      });
     }
     for (const auto &dd : *Doxygen::dirLinkedMap)
     {
-      msg("Generate XML output for dir %s\n",qPrint(dd->name()));
-      generateXMLForDir(dd.get(),t);
+      compounds.push_back([dd=dd.get()](TextStream &ti)
+      {
+        msg("Generate XML output for dir %s\n",qPrint(dd->name()));
+        generateXMLForDir(dd,ti);
+      });
     }
     for (const auto &pd : *Doxygen::exampleLinkedMap)
     {
-      msg("Generating XML output for example %s\n",qPrint(pd->name()));
-      generateXMLForPage(pd.get(),t,TRUE);
+      compounds.push_back([pd=pd.get()](TextStream &ti)
+      {
+        msg("Generating XML output for example %s\n",qPrint(pd->name()));
+        generateXMLForPage(pd,ti,TRUE);
+      });
     }
     if (Doxygen::mainPage)
     {
-      msg("Generating XML output for the main page\n");
-      generateXMLForPage(Doxygen::mainPage.get(),t,FALSE);
+      compounds.push_back([](TextStream &ti)
+      {
+        msg("Generating XML output for the main page\n");
+        generateXMLForPage(Doxygen::mainPage.get(),ti,FALSE);
+      });
+    }
+    for (const auto &entry : generateXMLCompounds(compounds))
+    {
+      t << entry;
     }
 
     //t << "  </compoundlist>\n";
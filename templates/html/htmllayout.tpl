@@ -99,6 +99,7 @@
 {% opensubindex nav %}
 
 {# ----------- HTML DOCUMENTATION PAGES ------------ #}
+{# pages created with 'parallel' only read the context and are written by the thread pool #}
 
 {# write main page documentation #}
 {% with page=mainPage compound=mainPage isMainPage=True %}
@@ -108,23 +109,23 @@
 {# write namespace documentation pages #}
 {% for compound in namespaceList %}
   {% with page=compound %}
-    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlnamespace.tpl' %}
+    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlnamespace.tpl' parallel %}
   {% endwith %}
 {% endfor %}
 
 {# write concept documentation pages #}
 {% for compound in conceptList %}
   {% with page=compound %}
-    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlconcept.tpl' %}
+    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlconcept.tpl' parallel %}
   {% endwith %}
 {% endfor %}
 
 {# write class documentation pages #}
 {% for compound in classList %}
   {% with page=compound %}
-    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlclass.tpl' %}
+    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlclass.tpl' parallel %}
     {% if compound.allMembersList and not config.OPTIMIZE_OUTPUT_FOR_C %}
-      {% create compound.allMembersFileName|append:config.HTML_FILE_EXTENSION from 'htmlallmembers.tpl' %}
+      {% create compound.allMembersFileName|append:config.HTML_FILE_EXTENSION from 'htmlallmembers.tpl' parallel %}
     {% endif %}
   {% endwith %}
 {% endfor %}
@@ -134,7 +135,7 @@
   {% with page=compound %}
     {# TODO: to deal with clang optimization, we need to write the sources in a different order! #}
     {% if compound.hasSourceFile %}
-      {% create compound.sourceFileName|append:config.HTML_FILE_EXTENSION from 'htmlsource.tpl' %}
+      {% create compound.sourceFileName|append:config.HTML_FILE_EXTENSION from 'htmlsource.tpl' parallel %}
     {% endif %}
   {% endwith %}
 {% endfor %}
@@ -142,28 +143,28 @@
 {# write file documentation pages #}
 {% for compound in fileList %}
   {% with page=compound %}
-    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlfile.tpl' %}
+    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlfile.tpl' parallel %}
   {% endwith %}
 {% endfor %}
 
 {# write related page documentation #}
 {% for compound in pageList %}
   {% with page=compound isMainPage=False %}
-    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlpage.tpl' %}
+    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlpage.tpl' parallel %}
   {% endwith %}
 {% endfor %}
 
 {# write module documentation #}
 {% for compound in moduleList %}
   {% with page=compound %}
-    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlmodule.tpl' %}
+    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlmodule.tpl' parallel %}
   {% endwith %}
 {% endfor %}
 
 {# write example documentation #}
 {% for compound in exampleList %}
   {% with page=compound %}
-    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlexample.tpl' %}
+    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmlexample.tpl' parallel %}
   {% endwith %}
 {% endfor %}
 
@@ -287,7 +288,7 @@
 {# write directory documentation pages #}
 {% for compound in dirList %}
   {% with page=compound %}
-    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmldir.tpl' %}
+    {% create compound.fileName|append:config.HTML_FILE_EXTENSION from 'htmldir.tpl' parallel %}
   {% endwith %}
 {% endfor %}
 
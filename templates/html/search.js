@@ -331,9 +331,17 @@ function SearchBox(name, resultsPath, label, extension)
     var idx = indexSectionsWithContent[this.searchIndex].indexOf(idxChar);
     if (idx!=-1)
     {
-       var hexCode=idx.toString(16);
-       resultsPage = this.resultsPath + '/' + indexSectionNames[this.searchIndex] + '_' + hexCode + this.extension;
-       resultsPageWithSearch = resultsPage+'?'+escape(searchValue);
+       if (typeof searchShards!='undefined') // compact search data
+       {
+         resultsPage = this.resultsPath + '/results' + this.extension;
+         resultsPageWithSearch = resultsPage+'?'+this.searchIndex+'&'+escape(searchValue);
+       }
+       else
+       {
+         var hexCode=idx.toString(16);
+         resultsPage = this.resultsPath + '/' + indexSectionNames[this.searchIndex] + '_' + hexCode + this.extension;
+         resultsPageWithSearch = resultsPage+'?'+escape(searchValue);
+       }
        hasResultsPage = true;
     }
     else // nothing available for this search term
@@ -519,6 +527,25 @@ function SearchResults(name)
       return true;
     }
 
+    // Searches for the string passed in the URL query ("?<index section>&<search>")
+    // of the results page used for compact search data. First loads the
+    // shards needed and inserts the results of the index section.
+    this.SearchCompact = function()
+    {
+      var query = window.location.search.substring(1); // Remove the leading '?'
+      var sep = query.indexOf('&');
+      var section = parseInt(query.substring(0,sep));
+      var search = unescape(query.substring(sep+1));
+      var results = this;
+      loadSearchShards(findSearchShards(search.replace(/^ +/, "").toLowerCase()),function()
+      {
+        searchData = createSearchData(section);
+        createResults();
+        document.getElementById("Loading").style.display='none';
+        results.Search(search);
+      });
+    }
+
     // return the first item with index index or higher that is visible
     this.NavNext = function(index)
     {
@@ -777,6 +804,111 @@ function createResults()
   }
 }
 
+// ------------ compact search data
+
+var searchData;
+var searchShardData = [];
+var searchShardsPending = 0;
+var searchShardsLoaded;
+
+// returns the first character of str, taking surrogate pairs into account
+function firstChar(str)
+{
+  var code = str.charCodeAt(0);
+  if (0xD800 <= code && code <= 0xDBFF && str.length > 1) // surrogate pair
+  {
+    return str.substr(0, 2);
+  }
+  return str.substr(0, 1);
+}
+
+// returns the indices of the shards that can contain matches for search
+function findSearchShards(search)
+{
+  var result = [];
+  if (search.length==0) return result;
+  var letter = firstChar(search);
+  var letters = letter + firstChar(search.substring(letter.length));
+  for (var i=0; i<searchShards.length; i++)
+  {
+    var key = searchShards[i];
+    if (key==letter || key==letters ||                              // shard for the first (two) letter(s)
+        (letters==letter && key.substr(0, letter.length)==letter))  // all shards for the first letter
+    {
+      result.push(i);
+    }
+  }
+  return result;
+}
+
+// called by each shard file when it is loaded
+function searchShard(index,data)
+{
+  searchShardData[index] = data;
+  shardDone();
+}
+
+function shardDone()
+{
+  if (searchShardsPending>0 && --searchShardsPending==0)
+  {
+    searchShardsLoaded();
+  }
+}
+
+// loads the shard files with the given indices and then calls done
+function loadSearchShards(shards,done)
+{
+  searchShardsPending = shards.length;
+  searchShardsLoaded = done;
+  if (shards.length==0)
+  {
+    done();
+    return;
+  }
+  for (var i=0; i<shards.length; i++)
+  {
+    var script = document.createElement('script');
+    script.type = 'text/javascript';
+    script.src = 'shard_'+shards[i].toString(16)+'.js';
+    script.onerror = shardDone;
+    document.getElementsByTagName('head')[0].appendChild(script);
+  }
+}
+
+// converts the loaded shards into the searchData of the given index section
+function createSearchData(section)
+{
+  var result = [];
+  var mask = 1<<section;
+  var cnt = 0;
+  for (var i=0; i<searchShardData.length; i++)
+  {
+    var shard = searchShardData[i];
+    if (!shard) continue;
+    for (var e=0; e<shard.e.length; e++)
+    {
+      var entry = shard.e[e];
+      var children = [];
+      for (var c=2; c<entry.length; c++)
+      {
+        if (entry[c][0] & mask) children.push(entry[c]);
+      }
+      if (children.length==0) continue;
+      var item = [entry[1]];
+      for (var c=0; c<children.length; c++)
+      {
+        var child = children[c];
+        var url = shard.u[child[1]];
+        if (child[2]) url += '#'+child[2];
+        item.push([url, child[5], shard.s[children.length==1 ? child[3] : child[4]]]);
+      }
+      result.push([entry[0]+'_'+(cnt++), item]);
+    }
+  }
+  return result;
+}
+
 function init_search()
 {
   var results = document.getElementById("MSearchSelectWindow");